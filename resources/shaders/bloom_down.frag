@@ -0,0 +1,46 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoords;
+
+uniform sampler2D source;
+uniform bool prefilter;     // first level only: the bright pass is folded into the downsample
+uniform float threshold;    // luminance a pixel needs to bloom
+
+vec3 tap(vec2 uv)
+{
+    vec4 c = texture(source, uv);
+    if (!prefilter) return c.rgb;
+
+    // alpha 0 marks the background, which never blooms
+    if (c.a < 0.5) return vec3(0.0);
+    float brightness = dot(c.rgb, vec3(0.2126, 0.7152, 0.0722));
+    return brightness > threshold ? c.rgb : vec3(0.0);
+}
+
+// 13-tap downsample: five overlapping 2x2 boxes (one centred, four diagonal) weighted 0.5 / 0.125 each,
+// which keeps the chain free of the shimmer a single bilinear tap gives on moving highlights
+void main()
+{
+    vec2 t = 1.0 / vec2(textureSize(source, 0));
+
+    vec3 a = tap(TexCoords + t * vec2(-2.0,  2.0));
+    vec3 b = tap(TexCoords + t * vec2( 0.0,  2.0));
+    vec3 c = tap(TexCoords + t * vec2( 2.0,  2.0));
+    vec3 d = tap(TexCoords + t * vec2(-2.0,  0.0));
+    vec3 e = tap(TexCoords);
+    vec3 f = tap(TexCoords + t * vec2( 2.0,  0.0));
+    vec3 g = tap(TexCoords + t * vec2(-2.0, -2.0));
+    vec3 h = tap(TexCoords + t * vec2( 0.0, -2.0));
+    vec3 i = tap(TexCoords + t * vec2( 2.0, -2.0));
+    vec3 j = tap(TexCoords + t * vec2(-1.0,  1.0));
+    vec3 k = tap(TexCoords + t * vec2( 1.0,  1.0));
+    vec3 l = tap(TexCoords + t * vec2(-1.0, -1.0));
+    vec3 m = tap(TexCoords + t * vec2( 1.0, -1.0));
+
+    vec3 result = e * 0.125;
+    result += (a + c + g + i) * 0.03125;
+    result += (b + d + f + h) * 0.0625;
+    result += (j + k + l + m) * 0.125;
+
+    FragColor = vec4(result, 1.0);
+}
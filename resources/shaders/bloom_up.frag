@@ -0,0 +1,24 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoords;
+
+uniform sampler2D source;    // next smaller level of the bloom chain
+uniform float filterRadius;  // tent radius in source texels
+
+// 3x3 tent upsample; the result is added onto the larger level by blending
+void main()
+{
+    vec2 t = filterRadius / vec2(textureSize(source, 0));
+
+    vec3 result = texture(source, TexCoords).rgb * 4.0;
+    result += (texture(source, TexCoords + vec2( t.x, 0.0)).rgb +
+               texture(source, TexCoords + vec2(-t.x, 0.0)).rgb +
+               texture(source, TexCoords + vec2(0.0,  t.y)).rgb +
+               texture(source, TexCoords + vec2(0.0, -t.y)).rgb) * 2.0;
+    result += texture(source, TexCoords + vec2( t.x,  t.y)).rgb +
+              texture(source, TexCoords + vec2(-t.x,  t.y)).rgb +
+              texture(source, TexCoords + vec2( t.x, -t.y)).rgb +
+              texture(source, TexCoords + vec2(-t.x, -t.y)).rgb;
+
+    FragColor = vec4(result / 16.0, 1.0);
+}
@@ -5,13 +5,20 @@ in vec3 worldNormal;
 
 out vec4 fragColor;
 
-// ========== scene globals ===========
-uniform float global_ka;
-uniform float global_kd;
-uniform float global_ks;
-
-// ========== camera ===========
-uniform vec3 cameraPos;
+// ========== scene block (one UBO upload per frame, shared with default.vert) ===========
+layout(std140) uniform SceneBlock {
+    mat4 view;
+    mat4 proj;
+    vec4 cameraPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    float global_ka;
+    float global_kd;
+    float global_ks;
+    float timeSec;
+    float bgScrollOffset;
+    float starScrollSpeed;
+};
 
 // ========== material ===========
 uniform vec4 matAmbient;
@@ -19,15 +26,6 @@ uniform vec4 matDiffuse;
 uniform vec4 matSpecular;
 uniform float matShininess;
 uniform vec4 matEmissive;
-uniform bool useBackgroundTex;
-uniform sampler2D backgroundTex;
-uniform float timeSec;
-uniform float bgScrollOffset;
-uniform float starScrollSpeed;
-
-// ========== light ===========
-uniform vec3 lightPos;
-uniform vec3 lightColor;
 
 // For monster
 in vec2 fragTexCoord;
@@ -41,6 +39,12 @@ uniform bool useMeshEmissiveTex;
 uniform sampler2D meshEmissiveTex;
 uniform bool enableStarfield;
 
+// Instancing: material colors of batched primitives come per instance
+uniform bool useInstancing;
+flat in vec4 instEmissive;
+flat in vec4 instDiffuse;
+flat in vec4 instAmbient;
+
 
 // ===============================================
 // STARFIELD — Procedural far-field galaxy glow
@@ -105,39 +109,20 @@ vec3 computeStarfield(vec3 wp)
 
 
 
-const float PI = 3.14159265359;
-
-vec2 dirToEquirectUV(vec3 dir) {
-    float u = atan(dir.z, dir.x) / (2.0 * PI) + 0.5;
-    float v = 0.5 - asin(clamp(dir.y, -1.0, 1.0)) / PI;
-    return vec2(u, v);
-}
-
-vec2 zoomUV(vec2 uv, float zoom, vec2 offset) {
-    return (uv - 0.5) * zoom + 0.5 + offset;
-}
-
 void main()
 {
-    if (useBackgroundTex) {
-        const float bgZoom = 1.3;    // gentler zoom to reduce distortion
-        const vec2 bgOffset = vec2(0.02, -0.03);
-        vec3 dir = normalize(worldPos);
-        vec2 uv = dirToEquirectUV(dir);
-        uv.x = fract(uv.x + bgScrollOffset);
-        uv = zoomUV(uv, bgZoom, bgOffset);
-        uv.y = clamp(uv.y, 0.10, 0.90); // avoid pole regions that stretch the texture
-        vec3 texColor = texture(backgroundTex, uv).rgb;
-        fragColor = vec4(texColor, 0.0); // alpha=0 so bloom ignores background
-        return;
-    }
+    // The sky background is drawn by sky.frag after the geometry
 
     // Original light（object's shading）
     vec3 N = normalize(worldNormal);
-    vec3 V = normalize(cameraPos - worldPos);
-    vec3 L = normalize(lightPos - worldPos);
+    vec3 V = normalize(cameraPos.xyz - worldPos);
+    vec3 L = normalize(lightPos.xyz - worldPos);
+
+    vec4 diffuseColor = useInstancing ? instDiffuse : matDiffuse;
+    vec4 ambientColor = useInstancing ? instAmbient : matAmbient;
+    vec4 emissiveColor = useInstancing ? instEmissive : matEmissive;
 
-    vec3 baseColor = matDiffuse.rgb;
+    vec3 baseColor = diffuseColor.rgb;
     if (useMeshTexture) {
         if (!useNormalMap) {
             fragColor = texture(meshTexture, fragTexCoord);
@@ -152,22 +137,24 @@ void main()
             tangent = normalize(cross(N, vec3(1.0, 0.0, 0.0)));
         }
         vec3 bitangent = normalize(cross(N, tangent));
-        vec3 normalSample = texture(normalMapTexture, fragTexCoord).rgb * 2.0 - 1.0;
+        // Normal maps are stored as two-channel BC5; rebuild z from the unit-length xy
+        vec3 normalSample = vec3(texture(normalMapTexture, fragTexCoord).rg * 2.0 - 1.0, 0.0);
+        normalSample.z = sqrt(max(1.0 - dot(normalSample.xy, normalSample.xy), 0.0));
         N = normalize(tangent * normalSample.x + bitangent * normalSample.y + N * normalSample.z);
     }
 
-    vec3 ambient = global_ka * matAmbient.rgb;
+    vec3 ambient = global_ka * ambientColor.rgb;
     float diff = max(dot(N, L), 0.0);
-    vec3 diffuse = global_kd * diff * baseColor * lightColor;
+    vec3 diffuse = global_kd * diff * baseColor * lightColor.rgb;
 
     vec3 R = reflect(-L, N);
     float spec = pow(max(dot(V, R), 0.0), matShininess);
-    vec3 specular = global_ks * spec * matSpecular.rgb * lightColor;
+    vec3 specular = global_ks * spec * matSpecular.rgb * lightColor.rgb;
 
     vec3 shading = ambient + diffuse + specular;
 
     vec3 stars = enableStarfield ? computeStarfield(worldPos) : vec3(0.0);
-vec3 emissive = matEmissive.rgb;
+vec3 emissive = emissiveColor.rgb;
 if (useMeshEmissiveTex) {
     emissive += meshEmissive * texture(meshEmissiveTex, fragTexCoord).rgb;
 } else {
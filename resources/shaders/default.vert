@@ -8,23 +8,62 @@ layout(location = 2) in ivec4 boneIds;
 layout(location = 3) in vec4 boneWeights;
 layout(location = 4) in vec2 meshUV;
 
+// Instancing: per-instance model matrix (locations 5-8) and material colors
+layout(location = 5) in mat4 instanceModel;
+layout(location = 9) in vec4 instanceEmissive;
+layout(location = 10) in vec4 instanceDiffuse;
+layout(location = 11) in vec4 instanceAmbient;
+
 out vec3 worldPos;
 out vec3 worldNormal;
 // For monster
 out vec2 fragTexCoord;
+// Instancing
+flat out vec4 instEmissive;
+flat out vec4 instDiffuse;
+flat out vec4 instAmbient;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 proj;
+
+// ========== scene block (one UBO upload per frame, shared with default.frag) ===========
+layout(std140) uniform SceneBlock {
+    mat4 view;
+    mat4 proj;
+    vec4 cameraPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    float global_ka;
+    float global_kd;
+    float global_ks;
+    float timeSec;
+    float bgScrollOffset;
+    float starScrollSpeed;
+};
+
+uniform bool useInstancing;        // true for batched primitives (stars), model comes from the instance buffer
 
 // For monster
 uniform bool useSkinning;          // Bone index setting: GLB mesh=true, others are false
-uniform mat4 boneMatrices[200];    // Upload the skeletal matrix (insufficient to fill in identity)
+// Packed GLB meshes store 16-bit positions inside their bounds: objectPos * scale + offset
+uniform vec3 meshPosScale = vec3(1.0);
+uniform vec3 meshPosOffset = vec3(0.0);
+uniform samplerBuffer boneTexture; // Skinning palettes of the frame, three RGBA32F rows (3x4) per joint
+uniform int boneOffset;            // First texel of this instance's palette
+
+mat4 boneMatrix(int joint)
+{
+    int base = boneOffset + joint * 3;
+    vec4 r0 = texelFetch(boneTexture, base);
+    vec4 r1 = texelFetch(boneTexture, base + 1);
+    vec4 r2 = texelFetch(boneTexture, base + 2);
+    return transpose(mat4(r0, r1, r2, vec4(0.0, 0.0, 0.0, 1.0)));
+}
 
 void main()
 {
     // For monster
-    vec4 finalPos = vec4(objectPos, 1.0);
+    vec3 localPos = objectPos * meshPosScale + meshPosOffset;
+    vec4 finalPos = vec4(localPos, 1.0);
     vec3 finalNormal = objectNormal;
 
     if (useSkinning && (boneWeights.x + boneWeights.y + boneWeights.z + boneWeights.w > 0.0)) {
@@ -35,23 +74,25 @@ void main()
         float totalWeight = boneWeights.x + boneWeights.y + boneWeights.z + boneWeights.w;
         if (totalWeight > 0.0) normalizedWeights /= totalWeight;
 
-        ivec4 ids = clamp(boneIds, ivec4(0), ivec4(199)); // 防止越界
-
         if (normalizedWeights.x > 0.0) {
-            skinnedPos   += boneMatrices[ids.x] * vec4(objectPos, 1.0) * normalizedWeights.x;
-            skinnedNormal += mat3(boneMatrices[ids.x]) * objectNormal * normalizedWeights.x;
+            mat4 bone = boneMatrix(boneIds.x);
+            skinnedPos   += bone * vec4(localPos, 1.0) * normalizedWeights.x;
+            skinnedNormal += mat3(bone) * objectNormal * normalizedWeights.x;
         }
         if (normalizedWeights.y > 0.0) {
-            skinnedPos   += boneMatrices[ids.y] * vec4(objectPos, 1.0) * normalizedWeights.y;
-            skinnedNormal += mat3(boneMatrices[ids.y]) * objectNormal * normalizedWeights.y;
+            mat4 bone = boneMatrix(boneIds.y);
+            skinnedPos   += bone * vec4(localPos, 1.0) * normalizedWeights.y;
+            skinnedNormal += mat3(bone) * objectNormal * normalizedWeights.y;
         }
         if (normalizedWeights.z > 0.0) {
-            skinnedPos   += boneMatrices[ids.z] * vec4(objectPos, 1.0) * normalizedWeights.z;
-            skinnedNormal += mat3(boneMatrices[ids.z]) * objectNormal * normalizedWeights.z;
+            mat4 bone = boneMatrix(boneIds.z);
+            skinnedPos   += bone * vec4(localPos, 1.0) * normalizedWeights.z;
+            skinnedNormal += mat3(bone) * objectNormal * normalizedWeights.z;
         }
         if (normalizedWeights.w > 0.0) {
-            skinnedPos   += boneMatrices[ids.w] * vec4(objectPos, 1.0) * normalizedWeights.w;
-            skinnedNormal += mat3(boneMatrices[ids.w]) * objectNormal * normalizedWeights.w;
+            mat4 bone = boneMatrix(boneIds.w);
+            skinnedPos   += bone * vec4(localPos, 1.0) * normalizedWeights.w;
+            skinnedNormal += mat3(bone) * objectNormal * normalizedWeights.w;
         }
 
         finalPos = skinnedPos;
@@ -62,14 +103,18 @@ void main()
 
     //worldPos = vec3(model * vec4(objectPos, 1.0));
     // For monster
-    worldPos = vec3(model * finalPos);
+    mat4 modelMatrix = useInstancing ? instanceModel : model;
+    worldPos = vec3(modelMatrix * finalPos);
 
     // use inverse matrix
-    mat3 inversedMatrix = mat3(transpose(inverse(model)));
+    mat3 inversedMatrix = mat3(transpose(inverse(modelMatrix)));
     // worldNormal = normalize(inversedMatrix * objectNormal);
     // For monster
     worldNormal = normalize(inversedMatrix * finalNormal);
     fragTexCoord = meshUV;
+    instEmissive = instanceEmissive;
+    instDiffuse = instanceDiffuse;
+    instAmbient = instanceAmbient;
 
     // gl_Position = proj * view * model * vec4(objectPos, 1.0);
     // For monster
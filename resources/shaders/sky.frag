@@ -0,0 +1,62 @@
+#version 330 core
+
+in vec2 ndc;
+
+out vec4 fragColor;
+
+// ========== scene block (one UBO upload per frame, shared with default.vert / default.frag) ===========
+layout(std140) uniform SceneBlock {
+    mat4 view;
+    mat4 proj;
+    vec4 cameraPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    float global_ka;
+    float global_kd;
+    float global_ks;
+    float timeSec;
+    float bgScrollOffset;
+    float starScrollSpeed;
+};
+
+uniform sampler2D backgroundTex;
+uniform mat4 invViewProj;
+uniform vec4 skySphere;    // xyz centre, w radius of the sphere the texture is mapped onto
+
+const float PI = 3.14159265359;
+
+vec2 dirToEquirectUV(vec3 dir) {
+    float u = atan(dir.z, dir.x) / (2.0 * PI) + 0.5;
+    float v = 0.5 - asin(clamp(dir.y, -1.0, 1.0)) / PI;
+    return vec2(u, v);
+}
+
+vec2 zoomUV(vec2 uv, float zoom, vec2 offset) {
+    return (uv - 0.5) * zoom + 0.5 + offset;
+}
+
+void main()
+{
+    // View ray through this pixel, from its near-plane to its far-plane point
+    vec4 nearPoint = invViewProj * vec4(ndc, -1.0, 1.0);
+    vec4 farPoint = invViewProj * vec4(ndc, 1.0, 1.0);
+    vec3 origin = nearPoint.xyz / nearPoint.w;
+    vec3 ray = normalize(farPoint.xyz / farPoint.w - origin);
+
+    // Where the ray leaves the sky sphere, as a direction from the world origin (what the sphere
+    // mesh's worldPos gave); from outside the sphere fall back to the ray itself
+    vec3 toOrigin = origin - skySphere.xyz;
+    float b = dot(toOrigin, ray);
+    float c = dot(toOrigin, toOrigin) - skySphere.w * skySphere.w;
+    float disc = b * b - c;
+    vec3 dir = disc > 0.0 ? normalize(origin + ray * (-b + sqrt(disc))) : ray;
+
+    const float bgZoom = 1.3;    // gentler zoom to reduce distortion
+    const vec2 bgOffset = vec2(0.02, -0.03);
+    vec2 uv = dirToEquirectUV(dir);
+    uv.x = fract(uv.x + bgScrollOffset);
+    uv = zoomUV(uv, bgZoom, bgOffset);
+    uv.y = clamp(uv.y, 0.10, 0.90); // avoid pole regions that stretch the texture
+    vec3 texColor = texture(backgroundTex, uv).rgb;
+    fragColor = vec4(texColor, 0.0); // alpha=0 so bloom ignores background
+}
@@ -0,0 +1,12 @@
+#version 330 core
+
+out vec2 ndc;
+
+void main()
+{
+    // One triangle covering the screen: (-1,-1), (3,-1), (-1,3)
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+    ndc = pos;
+    // On the far plane, so the GL_EQUAL depth test only passes where no geometry was drawn
+    gl_Position = vec4(pos, 1.0, 1.0);
+}
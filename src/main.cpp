@@ -1,13 +1,69 @@
 #include "mainwindow.h"
+#include "offlinerenderer.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QScreen>
 #include <iostream>
 #include <QSettings>
 #include <QResource>
+#include <cstring>
+
+namespace {
+bool hasHeadlessFlag(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) return true;
+    }
+    return false;
+}
+
+// Fills options from --scene/--out/--frames/--start/--fps/--size; false on a malformed value
+bool parseOfflineOptions(const QApplication &app, OfflineRenderOptions &options) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders a scene to PNG frames without a window.");
+    parser.addHelpOption();
+    parser.addOption({"headless", "Render offscreen instead of opening the window."});
+    parser.addOption({"scene", "Scene JSON to load (default: starfield only).", "path"});
+    parser.addOption({"out", "Output directory (default: frames).", "dir", "frames"});
+    parser.addOption({"frames", "Number of frames to write (default: 120).", "count", "120"});
+    parser.addOption({"start", "Index of the first frame to write (default: 0).", "index", "0"});
+    parser.addOption({"fps", "Fixed simulation rate (default: 30).", "rate", "30"});
+    parser.addOption({"size", "Output size as WIDTHxHEIGHT (default: 1280x720).", "size", "1280x720"});
+    parser.process(app);
+
+    bool ok = true;
+    bool valid = true;
+    options.scenePath = parser.value("scene").toStdString();
+    options.outputDir = parser.value("out").toStdString();
+    options.frameCount = parser.value("frames").toInt(&ok);
+    valid &= ok;
+    options.startFrame = parser.value("start").toInt(&ok);
+    valid &= ok;
+    options.fps = parser.value("fps").toFloat(&ok);
+    valid &= ok;
+
+    QStringList size = parser.value("size").split('x');
+    if (size.size() == 2) {
+        options.width = size[0].toInt(&ok);
+        valid &= ok;
+        options.height = size[1].toInt(&ok);
+        valid &= ok;
+    } else {
+        valid = false;
+    }
+    return valid;
+}
+}
 
 int main(int argc, char *argv[]) {
     Q_INIT_RESOURCE(Resources);
+
+    // Headless runs must not need a display; let an explicit QT_QPA_PLATFORM (e.g. eglfs) win
+    const bool headless = hasHeadlessFlag(argc, argv);
+    if (headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication a(argc, argv);
 
     QCoreApplication::setApplicationName("Project 5: Realtime");
@@ -19,6 +75,15 @@ int main(int argc, char *argv[]) {
     fmt.setProfile(QSurfaceFormat::CoreProfile);
     QSurfaceFormat::setDefaultFormat(fmt);
 
+    if (headless) {
+        OfflineRenderOptions options;
+        if (!parseOfflineOptions(a, options)) {
+            std::cerr << "Invalid headless options, see --help" << std::endl;
+            return 1;
+        }
+        return runOfflineRender(options);
+    }
+
     MainWindow w;
     w.initialize();
     w.resize(1280, 720);  // 16:9 宽高比 (1280x720)
@@ -40,12 +40,17 @@ void MainWindow::initialize() {
 
     QLabel *param1_label = new QLabel(); // Parameter 1 label
     param1_label->setText("Bloom Strength:");
+    QLabel *exposure_label = new QLabel(); // Exposure label
+    exposure_label->setText("Exposure:");
     QLabel *param2_label = new QLabel(); // Parameter 2 label
     param2_label->setText("Starfield Scroll Speed:");
     QLabel *near_label = new QLabel(); // Near plane label
     near_label->setText("Near Plane:");
     QLabel *far_label = new QLabel(); // Far plane label
     far_label->setText("Far Plane:");
+    QLabel *profiler_label = new QLabel(); // Profiler label
+    profiler_label->setText("Profiling");
+    profiler_label->setFont(font);
 
 
     // From old Project 6
@@ -65,13 +70,30 @@ void MainWindow::initialize() {
     saveImage = new QPushButton();
     saveImage->setText(QStringLiteral("Save Image"));
 
+    recordButton = new QPushButton();
+    recordButton->setText(QStringLiteral("Record Frames"));
+
     // ANIMATION: create play button
     playButton = new QPushButton();
     playButton->setText(QStringLiteral("Play Animation"));
 
+    // Frame timing overlay / CSV log
+    profilerBox = new QCheckBox();
+    profilerBox->setText(QStringLiteral("Show Frame Timings"));
+    profilerBox->setChecked(settings.showProfiler);
+    profilerCsvBox = new QCheckBox();
+    profilerCsvBox->setText(QStringLiteral("Log Frame Timings to CSV"));
+    profilerCsvBox->setChecked(false);
+    // Scene pass resolution follows the GPU frame time; off renders at native resolution
+    dynamicResolutionBox = new QCheckBox();
+    dynamicResolutionBox->setText(QStringLiteral("Dynamic Resolution"));
+    dynamicResolutionBox->setChecked(settings.dynamicResolution);
+
     // Creates the boxes containing the parameter sliders and number boxes
     QGroupBox *p1Layout = new QGroupBox(); // horizonal slider 1 alignment
     QHBoxLayout *l1 = new QHBoxLayout();
+    QGroupBox *exposureLayout = new QGroupBox(); // horizonal exposure slider alignment
+    QHBoxLayout *lexposure = new QHBoxLayout();
     QGroupBox *p2Layout = new QGroupBox(); // horizonal slider 2 alignment
     QHBoxLayout *l2 = new QHBoxLayout();
 
@@ -91,6 +113,21 @@ void MainWindow::initialize() {
     bloomBox->setSingleStep(0.1);
     bloomBox->setValue(settings.bloomStrength);
 
+    exposureSlider = new QSlider(Qt::Orientation::Horizontal);
+    exposureSlider->setTickInterval(1);
+    exposureSlider->setMinimum(10);
+    exposureSlider->setMaximum(400); // maps to 0.1 - 4.0
+    exposureSlider->setSingleStep(1);
+    exposureSlider->setPageStep(10);
+    exposureSlider->setValue(int(std::round(settings.exposure * 100.f)));
+
+    exposureBox = new QDoubleSpinBox();
+    exposureBox->setDecimals(2);
+    exposureBox->setMinimum(0.1);
+    exposureBox->setMaximum(4.0);
+    exposureBox->setSingleStep(0.1);
+    exposureBox->setValue(settings.exposure);
+
     scrollSlider = new QSlider(Qt::Orientation::Horizontal);
     scrollSlider->setTickInterval(1);
     scrollSlider->setMinimum(0);
@@ -111,6 +148,10 @@ void MainWindow::initialize() {
     l1->addWidget(bloomBox);
     p1Layout->setLayout(l1);
 
+    lexposure->addWidget(exposureSlider);
+    lexposure->addWidget(exposureBox);
+    exposureLayout->setLayout(lexposure);
+
     l2->addWidget(scrollSlider);
     l2->addWidget(scrollBox);
     p2Layout->setLayout(l2);
@@ -157,10 +198,13 @@ void MainWindow::initialize() {
 
     vLayout->addWidget(uploadFile);
     vLayout->addWidget(saveImage);
+    vLayout->addWidget(recordButton);
     vLayout->addWidget(playButton);  // ANIMATION: add play button
     vLayout->addWidget(tesselation_label);
     vLayout->addWidget(param1_label);
     vLayout->addWidget(p1Layout);
+    vLayout->addWidget(exposure_label);
+    vLayout->addWidget(exposureLayout);
     vLayout->addWidget(param2_label);
     vLayout->addWidget(p2Layout);
     vLayout->addWidget(camera_label);
@@ -168,6 +212,10 @@ void MainWindow::initialize() {
     vLayout->addWidget(nearLayout);
     vLayout->addWidget(far_label);
     vLayout->addWidget(farLayout);
+    vLayout->addWidget(profiler_label);
+    vLayout->addWidget(profilerBox);
+    vLayout->addWidget(profilerCsvBox);
+    vLayout->addWidget(dynamicResolutionBox);
 
     // From old Project 6
     // vLayout->addWidget(filters_label);
@@ -177,6 +225,7 @@ void MainWindow::initialize() {
     connectUIElements();
 
     onBloomSliderChanged(bloomSlider->value());
+    onExposureSliderChanged(exposureSlider->value());
     onScrollSliderChanged(scrollSlider->value());
 
     // Set default values for near and far planes
@@ -185,6 +234,7 @@ void MainWindow::initialize() {
 }
 
 void MainWindow::finish() {
+    realtime->stopRecording();
     realtime->finish();
     delete(realtime);
 }
@@ -195,11 +245,14 @@ void MainWindow::connectUIElements() {
     //connectKernelBasedFilter();
     connectUploadFile();
     connectSaveImage();
+    connectRecordButton();
     connectPlayButton();  // ANIMATION: connect play button
     connectBloomControls();
+    connectExposureControls();
     connectScrollControls();
     connectNear();
     connectFar();
+    connectProfilerControls();
 }
 
 
@@ -219,6 +272,10 @@ void MainWindow::connectSaveImage() {
     connect(saveImage, &QPushButton::clicked, this, &MainWindow::onSaveImage);
 }
 
+void MainWindow::connectRecordButton() {
+    connect(recordButton, &QPushButton::clicked, this, &MainWindow::onRecordButton);
+}
+
 // ANIMATION: connect play button
 void MainWindow::connectPlayButton() {
     connect(playButton, &QPushButton::clicked, this, &MainWindow::onPlayButton);
@@ -231,6 +288,13 @@ void MainWindow::connectBloomControls() {
             this, &MainWindow::onBloomBoxChanged);
 }
 
+void MainWindow::connectExposureControls() {
+    connect(exposureSlider, &QSlider::valueChanged,
+            this, &MainWindow::onExposureSliderChanged);
+    connect(exposureBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::onExposureBoxChanged);
+}
+
 void MainWindow::connectScrollControls() {
     connect(scrollSlider, &QSlider::valueChanged,
             this, &MainWindow::onScrollSliderChanged);
@@ -244,6 +308,12 @@ void MainWindow::connectNear() {
             this, &MainWindow::onValChangeNearBox);
 }
 
+void MainWindow::connectProfilerControls() {
+    connect(profilerBox, &QCheckBox::toggled, this, &MainWindow::onProfilerToggled);
+    connect(profilerCsvBox, &QCheckBox::toggled, this, &MainWindow::onProfilerCsvToggled);
+    connect(dynamicResolutionBox, &QCheckBox::toggled, this, &MainWindow::onDynamicResolutionToggled);
+}
+
 void MainWindow::connectFar() {
     connect(farSlider, &QSlider::valueChanged, this, &MainWindow::onValChangeFarSlider);
     connect(farBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
@@ -303,6 +373,24 @@ void MainWindow::onSaveImage() {
     realtime->saveViewportImage(filePath.toStdString());
 }
 
+void MainWindow::onRecordButton() {
+    if (realtime->isRecording()) {
+        realtime->stopRecording();
+        recordButton->setText(QStringLiteral("Record Frames"));
+        return;
+    }
+
+    QString directory = QFileDialog::getExistingDirectory(this, tr("Record Frames To"),
+                                                          QDir::currentPath());
+    if (directory.isEmpty()) {
+        return;
+    }
+    realtime->startRecording(directory.toStdString());
+    if (realtime->isRecording()) {
+        recordButton->setText(QStringLiteral("Stop Recording"));
+    }
+}
+
 void MainWindow::onBloomSliderChanged(int value) {
     double newValue = value / 100.0;
     {
@@ -324,6 +412,27 @@ void MainWindow::onBloomBoxChanged(double newValue) {
     realtime->update();
 }
 
+void MainWindow::onExposureSliderChanged(int value) {
+    double newValue = value / 100.0;
+    {
+        QSignalBlocker blocker(exposureBox);
+        exposureBox->setValue(newValue);
+    }
+    settings.exposure = static_cast<float>(newValue);
+    realtime->update();
+}
+
+void MainWindow::onExposureBoxChanged(double newValue) {
+    if (newValue < 0.1) newValue = 0.1;
+    if (newValue > 4.0) newValue = 4.0;
+    {
+        QSignalBlocker blocker(exposureSlider);
+        exposureSlider->setValue(int(std::round(newValue * 100.0)));
+    }
+    settings.exposure = static_cast<float>(newValue);
+    realtime->update();
+}
+
 void MainWindow::onScrollSliderChanged(int value) {
     double newValue = value / 10000.0;
     {
@@ -378,3 +487,33 @@ void MainWindow::onPlayButton() {
     realtime->resetAnimation();
 }
 
+void MainWindow::onProfilerToggled(bool checked) {
+    settings.showProfiler = checked;
+    realtime->update();
+}
+
+void MainWindow::onDynamicResolutionToggled(bool checked) {
+    settings.dynamicResolution = checked;
+    realtime->update();
+}
+
+void MainWindow::onProfilerCsvToggled(bool checked) {
+    if (!checked) {
+        settings.profilerCsvPath.clear();
+        return;
+    }
+
+    QString filePath = QFileDialog::getSaveFileName(this, tr("Save Frame Timings"),
+                                                    QDir::currentPath()
+                                                        .append(QDir::separator())
+                                                        .append("frame_timings.csv"),
+                                                    tr("CSV Files (*.csv)"));
+    if (filePath.isEmpty()) {
+        QSignalBlocker blocker(profilerCsvBox);
+        profilerCsvBox->setChecked(false);
+        return;
+    }
+    std::cout << "Logging frame timings to: \"" << filePath.toStdString() << "\"." << std::endl;
+    settings.profilerCsvPath = filePath.toStdString();
+}
+
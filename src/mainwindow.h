@@ -20,10 +20,12 @@ public:
 private:
     void connectUIElements();
     void connectBloomControls();
+    void connectExposureControls();
     void connectScrollControls();
     void connectNear();
     void connectFar();
     void connectPlayButton();  // ANIMATION: connect play button
+    void connectProfilerControls();
 
     // From old Project 6
     // void connectPerPixelFilter();
@@ -31,6 +33,7 @@ private:
 
     void connectUploadFile();
     void connectSaveImage();
+    void connectRecordButton();
     Realtime *realtime;
     AspectRatioWidget *aspectRatioWidget;
 
@@ -40,15 +43,21 @@ private:
 
     QPushButton *uploadFile;
     QPushButton *saveImage;
+    QPushButton *recordButton;  // start/stop image-sequence capture
     QPushButton *playButton;  // ANIMATION: play/reset animation button
     QSlider *bloomSlider;
     QSlider *scrollSlider;
     QDoubleSpinBox *bloomBox;
+    QSlider *exposureSlider;
+    QDoubleSpinBox *exposureBox;
     QDoubleSpinBox *scrollBox;
     QSlider *nearSlider;
     QSlider *farSlider;
     QDoubleSpinBox *nearBox;
     QDoubleSpinBox *farBox;
+    QCheckBox *profilerBox;
+    QCheckBox *profilerCsvBox;
+    QCheckBox *dynamicResolutionBox;
 
 private slots:
     // From old Project 6
@@ -57,8 +66,11 @@ private slots:
 
     void onUploadFile();
     void onSaveImage();
+    void onRecordButton();
     void onBloomSliderChanged(int value);
     void onBloomBoxChanged(double value);
+    void onExposureSliderChanged(int value);
+    void onExposureBoxChanged(double value);
     void onScrollSliderChanged(int value);
     void onScrollBoxChanged(double value);
     void onValChangeNearSlider(int newValue);
@@ -66,5 +78,8 @@ private slots:
     void onValChangeNearBox(double newValue);
     void onValChangeFarBox(double newValue);
     void onPlayButton();  // ANIMATION: reset animation timer
+    void onProfilerToggled(bool checked);
+    void onProfilerCsvToggled(bool checked);
+    void onDynamicResolutionToggled(bool checked);
 
 };
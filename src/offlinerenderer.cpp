@@ -0,0 +1,133 @@
+// realtime.h pulls in GLEW, which has to come before Qt's OpenGL headers
+#include "realtime.h"
+#include "offlinerenderer.h"
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QSurfaceFormat>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include "settings.h"
+#include "utils/frame_capture.h"
+
+namespace {
+// Color + depth target the composite pass writes into
+struct OffscreenTarget {
+    GLuint fbo = 0;
+    GLuint color = 0;
+    GLuint depth = 0;
+
+    bool create(int width, int height) {
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+        glGenRenderbuffers(1, &color);
+        glBindRenderbuffer(GL_RENDERBUFFER, color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+
+        glGenRenderbuffers(1, &depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+        bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return complete;
+    }
+
+    void destroy() {
+        if (color) glDeleteRenderbuffers(1, &color);
+        if (depth) glDeleteRenderbuffers(1, &depth);
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+        color = depth = fbo = 0;
+    }
+};
+}
+
+int runOfflineRender(const OfflineRenderOptions &options) {
+    if (options.width <= 0 || options.height <= 0 || options.fps <= 0.f
+        || options.startFrame < 0 || options.frameCount <= 0) {
+        std::cerr << "Offline render: invalid size, fps or frame range" << std::endl;
+        return 1;
+    }
+
+    QOpenGLContext context;
+    context.setFormat(QSurfaceFormat::defaultFormat());
+    if (!context.create()) {
+        std::cerr << "Offline render: failed to create an OpenGL context" << std::endl;
+        return 1;
+    }
+
+    QOffscreenSurface surface;
+    surface.setFormat(context.format());
+    surface.create();
+    if (!surface.isValid() || !context.makeCurrent(&surface)) {
+        std::cerr << "Offline render: failed to make the offscreen context current" << std::endl;
+        return 1;
+    }
+
+    // Realtime::initializeGL runs glewInit again; the target just needs entry points first
+    glewExperimental = GL_TRUE;
+    if (GLenum err = glewInit(); err != GLEW_OK) {
+        std::cerr << "Error while initializing GL: " << glewGetErrorString(err) << std::endl;
+        return 1;
+    }
+
+    OffscreenTarget target;
+    if (!target.create(options.width, options.height)) {
+        std::cerr << "Offline render: output framebuffer is not complete" << std::endl;
+        target.destroy();
+        return 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.outputDir, ec);
+    if (ec) {
+        std::cerr << "Offline render: cannot create " << options.outputDir << ": " << ec.message() << std::endl;
+        target.destroy();
+        return 1;
+    }
+
+    // Same camera planes MainWindow starts with
+    settings.nearPlane = 0.1f;
+    settings.farPlane = 100.f;
+    settings.sceneFilePath = options.scenePath;
+
+    Realtime renderer;
+    renderer.initializeOffscreen(target.fbo, options.width, options.height);
+    renderer.setSceneFilePath(options.scenePath);
+    renderer.sceneChanged();
+    renderer.finishGlbLoads();   // frame 0 must already show every model
+
+    // Frame i shows the scene at t = i / fps. Frames before the range are simulated but not drawn,
+    // except the one right before it, which seeds the motion-blur history exactly like a full run.
+    const float dt = 1.f / options.fps;
+    const int endFrame = options.startFrame + options.frameCount;
+    FrameCapture capture;
+    char fileName[32];
+
+    for (int frame = 0; frame < endFrame; ++frame) {
+        if (frame >= options.startFrame - 1) {
+            renderer.renderFrame();
+        }
+        if (frame >= options.startFrame) {
+            std::snprintf(fileName, sizeof(fileName), "frame_%05d.png", frame);
+            capture.capture(target.fbo, options.width, options.height,
+                            (std::filesystem::path(options.outputDir) / fileName).string());
+        }
+        renderer.advanceTime(dt);
+    }
+    capture.releaseGL();   // drains the readback ring and waits for the encoders
+
+    const size_t written = capture.framesWritten();
+    std::cout << "Offline render: wrote " << written << " of " << options.frameCount
+              << " frames to " << options.outputDir << std::endl;
+
+    renderer.finish();
+    target.destroy();
+    context.doneCurrent();
+    return written == static_cast<size_t>(options.frameCount) ? 0 : 1;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+// Options for a headless render, filled from the command line in main.cpp
+struct OfflineRenderOptions {
+    std::string scenePath;              // scene JSON; empty renders the default starfield only
+    std::string outputDir = "frames";
+    int width = 1280;
+    int height = 720;
+    float fps = 30.f;                   // fixed timestep of 1 / fps between frames
+    int startFrame = 0;                 // first frame written; earlier frames are only simulated
+    int frameCount = 120;
+};
+
+/**
+ * Renders frames [startFrame, startFrame + frameCount) of a scene to <outputDir>/frame_NNNNN.png
+ * without a window. The GL context lives on a QOffscreenSurface, so it runs under the offscreen /
+ * EGL platform plugins (e.g. Mesa llvmpipe) with no display. Animation advances by a fixed timestep
+ * from t = 0, so the same frame index always produces the same image and a sequence can be split
+ * across processes by giving each one its own frame range.
+ *
+ * Needs a QApplication (Realtime is a widget) but never shows it. Returns a process exit code.
+ */
+int runOfflineRender(const OfflineRenderOptions &options);
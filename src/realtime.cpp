@@ -4,11 +4,16 @@
 #include <QMouseEvent>
 #include <QKeyEvent>
 #include <QImage>
+#include <QLabel>
 #include <iostream>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
+#include <numeric>
 #include "settings.h"
 #include "utils/shaderloader.h"
+#include "utils/texture_codec.h"
 #include "camera.h"
 #include "utils/sceneparser.h"
 #include <cmath>
@@ -32,9 +37,43 @@ Realtime::Realtime(QWidget *parent)
     m_keyMap[Qt::Key_Space]   = false;
 
     // If you must use this function, do not edit anything above this
+
+    // Frame timing overlay, drawn by Qt on top of the GL surface
+    m_profilerOverlay = new QLabel(this);
+    m_profilerOverlay->setStyleSheet("QLabel { color: #e0e0e0; background-color: rgba(0, 0, 0, 160);"
+                                     " font-family: monospace; font-size: 11px; padding: 4px; }");
+    m_profilerOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_profilerOverlay->move(8, 8);
+    m_profilerOverlay->hide();
 }
 
 namespace {
+// Instancing: model (16) + emissive (4) + diffuse (4) + ambient (4) floats per instance
+constexpr int kInstanceFloats = 28;
+constexpr GLuint kInstanceModelLoc = 5;     // mat4 takes locations 5..8
+constexpr GLuint kInstanceEmissiveLoc = 9;
+constexpr GLuint kInstanceDiffuseLoc = 10;
+constexpr GLuint kInstanceAmbientLoc = 11;
+
+// Post-processing target formats, one per stage
+constexpr GLenum kSceneColorFormat = GL_RGBA16F;       // HDR; alpha masks the background out of bloom
+constexpr GLenum kBloomFormat = GL_R11F_G11F_B10F;     // HDR colour only, 4 bytes per texel
+
+// Unsharp-mask strength the composite applies to a scene rendered at half resolution (less above it)
+constexpr float kUpscaleSharpness = 0.6f;
+
+// Uniform buffer binding point of the default shader's SceneBlock
+constexpr GLuint kSceneBlockBinding = 0;
+
+// For monster: staged GLB bytes uploaded per frame (~a 2k RGBA texture)
+constexpr size_t kGlbUploadBytesPerFrame = 16 * 1024 * 1024;
+
+// For monster: texture unit of the skinning palette buffer (units 0-2 and 5 are taken by the materials / sky)
+constexpr GLenum kBonePaletteUnit = GL_TEXTURE6;
+
+// For monster: clip offset between successive instances of one GLB (first instance starts at 0)
+constexpr float kGlbInstancePhaseStep = 0.37f;
+
 GLuint loadTextureFromResource(const QString &path) {
     QImage image(path);
     if (image.isNull()) {
@@ -47,13 +86,13 @@ GLuint loadTextureFromResource(const QString &path) {
     GLuint tex = 0;
     glGenTextures(1, &tex);
     glBindTexture(GL_TEXTURE_2D, tex);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    TextureCodec::applyFiltering();
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, glImage.width(), glImage.height(),
-                 0, GL_RGBA, GL_UNSIGNED_BYTE, glImage.constBits());
+    // Full mip chain so the backdrop does not shimmer when drawn smaller than its source
+    TextureCodec::upload(TextureFormat::RGBA8,
+                         TextureCodec::buildMipChain(glImage.constBits(), glImage.width(), glImage.height(), 4));
 
     glBindTexture(GL_TEXTURE_2D, 0);
     return tex;
@@ -61,18 +100,45 @@ GLuint loadTextureFromResource(const QString &path) {
 }
 
 void Realtime::finish() {
-    killTimer(m_timer);
+    if (!m_offscreen) killTimer(m_timer);
     this->makeCurrent();
 
     // Students: anything requiring OpenGL calls when the program exits should be done here
     glDeleteBuffers(1, &m_vbo);
     glDeleteVertexArrays(1, &m_vao);
 
+    deleteInstanceBatches();
+    m_geometryCache.clear();
+
     // For monster (Make sure to release the texture /VAO generated by tinygltf when exiting)
     deleteGlbResources();
     m_meshFiles.clear();
-
-    glDeleteProgram(m_shader);
+    m_glbPoses.clear();
+    m_glbPaletteSource.clear();
+    m_glbInstances.clear();
+    m_bonePalettes.cleanupGL();
+
+    m_profiler.cleanupGL();
+    m_profiler.closeCsv();
+    m_recording = false;
+    m_capture.releaseGL();
+
+    ShaderLoader::deleteShaderProgram(m_shader);
+    ShaderLoader::deleteShaderProgram(m_bloomDownShader);
+    ShaderLoader::deleteShaderProgram(m_bloomUpShader);
+    ShaderLoader::deleteShaderProgram(m_screenShader);
+    ShaderLoader::deleteShaderProgram(m_motionBlurShader);
+    ShaderLoader::deleteShaderProgram(m_skyShader);
+    if (m_skyVAO) {
+        glDeleteVertexArrays(1, &m_skyVAO);
+        m_skyVAO = 0;
+    }
+    m_renderGraph.cleanupGL();
+    m_dynamicResolution.cleanupGL();
+    if (m_sceneUBO) {
+        glDeleteBuffers(1, &m_sceneUBO);
+        m_sceneUBO = 0;
+    }
     if (m_backgroundTex) {
         glDeleteTextures(1, &m_backgroundTex);
         m_backgroundTex = 0;
@@ -82,9 +148,9 @@ void Realtime::finish() {
 }
 
 void Realtime::initializeGL() {
-    m_devicePixelRatio = this->devicePixelRatio();
+    m_devicePixelRatio = m_offscreen ? 1.0 : this->devicePixelRatio();
 
-    m_timer = startTimer(1000/60);
+    if (!m_offscreen) m_timer = startTimer(1000/60);
     m_elapsedTimer.start();
 
     // Initializing GL.
@@ -109,9 +175,14 @@ void Realtime::initializeGL() {
         ":/resources/shaders/default.frag"
         );
 
-    m_brightShader = ShaderLoader::createShaderProgram(
+    m_bloomDownShader = ShaderLoader::createShaderProgram(
         ":/resources/shaders/fullscreen_quad.vert",
-        ":/resources/shaders/bright.frag"
+        ":/resources/shaders/bloom_down.frag"
+        );
+
+    m_bloomUpShader = ShaderLoader::createShaderProgram(
+        ":/resources/shaders/fullscreen_quad.vert",
+        ":/resources/shaders/bloom_up.frag"
         );
 
     m_screenShader = ShaderLoader::createShaderProgram(
@@ -119,106 +190,39 @@ void Realtime::initializeGL() {
         ":/resources/shaders/screen.frag"
         );
 
-    m_blurShader = ShaderLoader::createShaderProgram(
+    m_motionBlurShader = ShaderLoader::createShaderProgram(
         ":/resources/shaders/fullscreen_quad.vert",
-        ":/resources/shaders/blur.frag"
+        ":/resources/shaders/motion_blur.frag"
         );
 
-    // ======================
-    // NEW: Create Scene FBO
-    // ======================
-    int w = width() * m_devicePixelRatio;
-    int h = height() * m_devicePixelRatio;
-
-    // 1) Create FBO
-    glGenFramebuffers(1, &m_sceneFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_sceneFBO);
-
-    // 2) Color Texture
-    glGenTextures(1, &m_sceneColorTex);
-    glBindTexture(GL_TEXTURE_2D, m_sceneColorTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, w, h, 0,
-                 GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                           GL_TEXTURE_2D, m_sceneColorTex, 0);
-    GLenum attachments[1] = { GL_COLOR_ATTACHMENT0 };
-    glDrawBuffers(1, attachments);
-
-    // 3) Depth texture (sample-able for motion blur)
-    glGenTextures(1, &m_sceneDepthTex);
-    glBindTexture(GL_TEXTURE_2D, m_sceneDepthTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, w, h, 0,
-                 GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-                           GL_TEXTURE_2D, m_sceneDepthTex, 0);
-
-    // Check
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cout << "Scene FBO is NOT complete!" << std::endl;
-    }
-
-    // unbind
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-
-    // ============================
-    // NEW: Bright-pass FBO
-    // ============================
-    glGenFramebuffers(1, &m_brightFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_brightFBO);
-
-    // bright texture
-    glGenTextures(1, &m_brightTex);
-    glBindTexture(GL_TEXTURE_2D, m_brightTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0,
-                 GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                           GL_TEXTURE_2D, m_brightTex, 0);
+    m_skyShader = ShaderLoader::createShaderProgram(
+        ":/resources/shaders/sky.vert",
+        ":/resources/shaders/sky.frag"
+        );
 
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cout << "Bright FBO NOT complete!\n";
+    cacheDefaultShaderUniforms();
+    m_profiler.initializeGL();
+    m_bonePalettes.initializeGL();
+    m_dynamicResolution.initializeGL();
+    m_overlayRefreshTimer.start();
+
+    // Scene constants live in one uniform buffer, updated once per frame
+    glGenBuffers(1, &m_sceneUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_sceneUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(SceneBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kSceneBlockBinding, m_sceneUBO);
+    for (GLuint program : {m_shader, m_skyShader}) {
+        if (GLuint block = glGetUniformBlockIndex(program, "SceneBlock"); block != GL_INVALID_INDEX) {
+            glUniformBlockBinding(program, block, kSceneBlockBinding);
+        }
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-
-    // ============================
-    // NEW: Blur FBOs (ping-pong)
-    // ============================
-    glGenFramebuffers(1, &m_pingFBO);
-    glGenFramebuffers(1, &m_pongFBO);
-
-    glGenTextures(1, &m_pingTex);
-    glGenTextures(1, &m_pongTex);
+    // The sky's fullscreen triangle is generated from gl_VertexID; core profile still wants a VAO bound
+    glGenVertexArrays(1, &m_skyVAO);
 
-    GLuint blurTextures[2] = { m_pingTex, m_pongTex };
-    GLuint blurFBOs[2] = { m_pingFBO, m_pongFBO };
-
-    for (int i = 0; i < 2; i++) {
-        glBindTexture(GL_TEXTURE_2D, blurTextures[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        glBindFramebuffer(GL_FRAMEBUFFER, blurFBOs[i]);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                               GL_TEXTURE_2D, blurTextures[i], 0);
-
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-            std::cout << "Blur FBO " << i << " NOT complete!\n";
-        }
-    }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // Scene and post-processing targets are allocated by the render graph on first use
+    m_renderGraph.setOutputSize(width() * m_devicePixelRatio, height() * m_devicePixelRatio);
 
 
     // ============================
@@ -275,23 +279,161 @@ void Realtime::initializeGL() {
 
 }
 
+// Resolve the default shader's uniform locations once from its reflected table
+void Realtime::cacheDefaultShaderUniforms() {
+    const UniformTable &table = ShaderLoader::uniforms(m_shader);
+    m_uniforms.model              = table.location("model");
+    m_uniforms.matAmbient         = table.location("matAmbient");
+    m_uniforms.matDiffuse         = table.location("matDiffuse");
+    m_uniforms.matSpecular        = table.location("matSpecular");
+    m_uniforms.matEmissive        = table.location("matEmissive");
+    m_uniforms.matShininess       = table.location("matShininess");
+    m_uniforms.enableStarfield    = table.location("enableStarfield");
+    m_uniforms.useInstancing      = table.location("useInstancing");
+    m_uniforms.useMeshTexture     = table.location("useMeshTexture");
+    m_uniforms.meshTexture        = table.location("meshTexture");
+    m_uniforms.useNormalMap       = table.location("useNormalMap");
+    m_uniforms.normalMapTexture   = table.location("normalMapTexture");
+    m_uniforms.meshEmissive       = table.location("meshEmissive");
+    m_uniforms.useMeshEmissiveTex = table.location("useMeshEmissiveTex");
+    m_uniforms.meshEmissiveTex    = table.location("meshEmissiveTex");
+    m_uniforms.useSkinning        = table.location("useSkinning");
+    m_uniforms.boneTexture        = table.location("boneTexture");
+    m_uniforms.boneOffset         = table.location("boneOffset");
+    m_uniforms.meshPosScale       = table.location("meshPosScale");
+    m_uniforms.meshPosOffset      = table.location("meshPosOffset");
+}
+
 void Realtime::paintGL() {
-    // === NEW: Before each frame starts, the depth test must be re-enabled (because bright pass was disabled after the previous frame).
-    glEnable(GL_DEPTH_TEST);
-    GLuint screenFBO = defaultFramebufferObject();
+    // Bail out if we have nothing to draw
+    if (!m_shader) {
+        return;
+    }
+    GLuint screenFBO = m_offscreen ? m_offscreenFBO : defaultFramebufferObject();
+    const int screenWidth = width() * m_devicePixelRatio;
+    const int screenHeight = height() * m_devicePixelRatio;
 
-    //===  NEW: Scene Pass ===
-    glBindFramebuffer(GL_FRAMEBUFFER, m_sceneFBO);
-    glViewport(0, 0, width() * m_devicePixelRatio, height() * m_devicePixelRatio);
+    // For monster: bring in GLBs that finished parsing since the last frame
+    {
+        FrameProfiler::CpuScope uploadScope(m_profiler, "glbUpload");
+        pumpGlbLoads(kGlbUploadBytesPerFrame);
+    }
 
-    // 1) Clear the scene framebuffer
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // motion vector for screen-space blur (G-buffer depth + camera/fish motion)
+    glm::vec3 currentCamPos = glm::vec3(m_renderData.cameraData.pos);
+    glm::vec2 camDelta = glm::vec2(currentCamPos.x - m_prevCamPos.x,
+                                   currentCamPos.z - m_prevCamPos.z);
+    float bgDelta = m_bgScrollOffset - m_prevBgScrollOffset;
 
-    // 2) Bail out if we have nothing to draw
-    if (!m_shader) {
-        return;
+    glm::vec2 motionVec(0.f);
+    float camLen = glm::length(camDelta);
+    if (!m_firstFrame && camLen > 1e-5f) {
+        // only blur when camera moves; background scroll alone won't blur
+        motionVec = camDelta * 0.02f + glm::vec2(bgDelta * 1.8f, 0.0f);
     }
 
+    // fish screen-space velocity contribution removed (only camera-based)
+    m_prevFishUVValid = false;
+
+    float motionLen = glm::length(motionVec) * 0.5f; // overall soften
+    if (motionLen < 0.002f) {
+        motionVec = glm::vec2(0.f);
+        motionLen = 0.f;
+    }
+    glm::vec2 motionDir = motionLen > 1e-5f ? motionVec / motionLen : glm::vec2(0.f);
+    float motionAmount = glm::clamp(motionLen, 0.f, 0.03f); // softer cap
+
+    // gate: only enable blur after fish eaten
+    bool blurEnabled = m_animationDirector.isFishEaten();
+
+    // Scene pass resolution follows GPU frame time; offscreen renders stay at full resolution
+    m_dynamicResolution.setEnabled(settings.dynamicResolution && !m_offscreen);
+    const float sceneScale = m_dynamicResolution.scale();
+
+    // =========================
+    // Frame graph: scene -> bloom chain -> (motion blur) -> composite. Passes whose output
+    // nothing reads are culled, and targets come from the graph's pool.
+    // =========================
+    using Resource = RenderGraph::Resource;
+    auto addPass = [this](const std::string &name, std::vector<Resource> reads, std::vector<Resource> writes,
+                          std::function<void()> execute) {
+        m_renderGraph.addPass(name, std::move(reads), std::move(writes), [this, name, execute]() {
+            FrameProfiler::CpuScope cpuScope(m_profiler, name);
+            FrameProfiler::GpuScope gpuScope(m_profiler, name);
+            execute();
+        });
+    };
+
+    Resource screen = m_renderGraph.importFramebuffer("screen", screenFBO, screenWidth, screenHeight);
+    Resource sceneColor = m_renderGraph.create("sceneColor", {kSceneColorFormat, sceneScale});
+    Resource sceneDepth = m_renderGraph.create("sceneDepth", {GL_DEPTH_COMPONENT24, sceneScale});   // sampled by motion blur
+
+    // Pass 1: Scene, then the sky wherever the scene left the far plane
+    addPass("scene", {}, {sceneColor, sceneDepth}, [this]() { renderScenePass(); });
+    if (m_skyShape >= 0) {
+        addPass("sky", {sceneColor, sceneDepth}, {sceneColor, sceneDepth}, [this]() { renderSkyPass(); });
+    }
+
+    // Pass 2: Bloom (bright-pass folded into a downsample chain, then tent upsamples back up)
+    // level 0 is half resolution, each further level halves again
+    std::array<Resource, kBloomLevels> bloom;
+    for (int level = 0; level < kBloomLevels; ++level) {
+        bloom[level] = m_renderGraph.create("bloom" + std::to_string(level),
+                                            {kBloomFormat, 1.f / float(2 << level)});
+    }
+    for (int level = 0; level < kBloomLevels; ++level) {
+        Resource source = level == 0 ? sceneColor : bloom[level - 1];
+        addPass("bloomDown" + std::to_string(level), {source}, {bloom[level]},
+                [this, source, level]() { bloomDownsamplePass(m_renderGraph.texture(source), level == 0); });
+    }
+    // Add each level, tent-filtered, onto the next larger one; level 0 ends up holding every radius
+    for (int level = kBloomLevels - 1; level > 0; --level) {
+        Resource source = bloom[level];
+        addPass("bloomUp" + std::to_string(level), {source, bloom[level - 1]}, {bloom[level - 1]},
+                [this, source]() { bloomUpsamplePass(m_renderGraph.texture(source)); });
+    }
+
+    // Pass 3: Motion blur; culled unless the composite reads it
+    Resource blurredColor = m_renderGraph.create("motionBlur", {kSceneColorFormat, sceneScale});
+    addPass("motionBlur", {sceneColor, sceneDepth}, {blurredColor},
+            [this, sceneColor, sceneDepth, motionDir, motionAmount]() {
+        motionBlurPass(m_renderGraph.texture(sceneColor), m_renderGraph.texture(sceneDepth),
+                       motionDir, motionAmount);
+    });
+
+    // Pass 4: Combine (scene + bloom), upscaled to the screen, exposed and tonemapped
+    Resource compositeScene = blurEnabled ? blurredColor : sceneColor;
+    addPass("composite", {compositeScene, bloom[0]}, {screen}, [this, compositeScene, bloom, sceneScale]() {
+        compositePass(m_renderGraph.texture(compositeScene), m_renderGraph.texture(bloom[0]), sceneScale);
+    });
+
+    m_dynamicResolution.beginFrame();
+    m_renderGraph.execute();
+    m_dynamicResolution.endFrame();
+
+    if (m_recording) {
+        char fileName[32];
+        std::snprintf(fileName, sizeof(fileName), "frame_%05d.png", m_recordFrame++);
+        m_capture.capture(screenFBO, screenWidth, screenHeight,
+                          (std::filesystem::path(m_recordDirectory) / fileName).string());
+    }
+
+    m_profiler.endFrame();
+
+    // update history for next frame
+    m_prevCamPos = currentCamPos;
+    m_prevBgScrollOffset = m_bgScrollOffset;
+    m_firstFrame = false;
+    m_prevViewProj = m_currViewProj;
+}
+
+// Draw the scene into the graph's sceneColor / sceneDepth targets (bound by the graph)
+void Realtime::renderScenePass() {
+    glEnable(GL_DEPTH_TEST);
+
+    // 1) Clear the scene framebuffer
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
     // 3) Bind the shader once per frame
     glUseProgram(m_shader);
 
@@ -325,49 +467,40 @@ void Realtime::paintGL() {
     glm::mat4 proj = m_camera.getProjMatrix();
     m_currViewProj = proj * view;
 
-    if (GLint uView = glGetUniformLocation(m_shader, "view"); uView != -1) {
-        glUniformMatrix4fv(uView, 1, GL_FALSE, &view[0][0]);
-    }
-    if (GLint uProj = glGetUniformLocation(m_shader, "proj"); uProj != -1) {
-        glUniformMatrix4fv(uProj, 1, GL_FALSE, &proj[0][0]);
-    }
-
-    // 5) Push the scene-wide lighting constants (global coefficients & camera position)
+    // 5) Push the scene-wide constants (camera, global coefficients, light) in one upload
     const SceneGlobalData &g = m_renderData.globalData;
-    if (GLint loc = glGetUniformLocation(m_shader, "global_ka"); loc != -1)
-        glUniform1f(loc, g.ka);
-    if (GLint loc = glGetUniformLocation(m_shader, "global_kd"); loc != -1)
-        glUniform1f(loc, g.kd);
-    if (GLint loc = glGetUniformLocation(m_shader, "global_ks"); loc != -1)
-        glUniform1f(loc, g.ks);
-    if (GLint loc = glGetUniformLocation(m_shader, "timeSec"); loc != -1)
-        glUniform1f(loc, timeSec);
-    if (GLint loc = glGetUniformLocation(m_shader, "bgScrollOffset"); loc != -1)
-        glUniform1f(loc, m_bgScrollOffset);
-    if (GLint loc = glGetUniformLocation(m_shader, "starScrollSpeed"); loc != -1)
-        glUniform1f(loc, 0.0025f);
-
     glm::vec3 camPos = glm::vec3(m_renderData.cameraData.pos);
-    if (GLint loc = glGetUniformLocation(m_shader, "cameraPos"); loc != -1)
-        glUniform3f(loc, camPos.x, camPos.y, camPos.z);
-
-    // 6) Upload lighting parameters
     glm::vec3 lightPos(5.f, 5.f, 5.f);
     glm::vec3 lightColor(1.05f, 0.95f, 0.75f); // warm tone for highlight/bloom
 
-    if (GLint loc = glGetUniformLocation(m_shader, "lightPos"); loc != -1)
-        glUniform3fv(loc, 1, &lightPos[0]);
-    if (GLint loc = glGetUniformLocation(m_shader, "lightColor"); loc != -1)
-        glUniform3fv(loc, 1, &lightColor[0]);
+    SceneBlock sceneBlock{};
+    sceneBlock.view = view;
+    sceneBlock.proj = proj;
+    sceneBlock.cameraPos = glm::vec4(camPos, 1.f);
+    sceneBlock.lightPos = glm::vec4(lightPos, 1.f);
+    sceneBlock.lightColor = glm::vec4(lightColor, 0.f);
+    sceneBlock.global_ka = g.ka;
+    sceneBlock.global_kd = g.kd;
+    sceneBlock.global_ks = g.ks;
+    sceneBlock.timeSec = timeSec;
+    sceneBlock.bgScrollOffset = m_bgScrollOffset;
+    sceneBlock.starScrollSpeed = 0.0025f;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_sceneUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(SceneBlock), &sceneBlock);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
 
     // For monster：Cache GLB-related uniform
-    GLint uUseMeshTexture = glGetUniformLocation(m_shader, "useMeshTexture");
-    GLint uUseNormalMap   = glGetUniformLocation(m_shader, "useNormalMap");
-    GLint uMeshEmissive   = glGetUniformLocation(m_shader, "meshEmissive");
-    GLint uUseSkinning    = glGetUniformLocation(m_shader, "useSkinning");
-    GLint uUseEmissiveTex = glGetUniformLocation(m_shader, "useMeshEmissiveTex");
-    GLint uEnableStarfield = glGetUniformLocation(m_shader, "enableStarfield");
+    GLint uUseMeshTexture = m_uniforms.useMeshTexture;
+    GLint uUseNormalMap   = m_uniforms.useNormalMap;
+    GLint uMeshEmissive   = m_uniforms.meshEmissive;
+    GLint uUseSkinning    = m_uniforms.useSkinning;
+    GLint uUseEmissiveTex = m_uniforms.useMeshEmissiveTex;
+    GLint uEnableStarfield = m_uniforms.enableStarfield;
+
+    // For monster: one palette write per skinned instance, shared by all of its meshes
+    uploadBonePalettes();
 
 
     // 7) Draw each mesh with its own material and model matrix
@@ -400,265 +533,178 @@ void Realtime::paintGL() {
         if (uUseEmissiveTex != -1) glUniform1i(uUseEmissiveTex, 0);
         if (uUseSkinning    != -1) glUniform1i(uUseSkinning, 0);
 
-        if (i >= m_vaos.size() || m_vaos[i] == 0) continue;
-        glBindVertexArray(m_vaos[i]);
-
-
-
-        const SceneMaterial &mat = shapeData.primitive.material;
-        if (GLint loc = glGetUniformLocation(m_shader, "matAmbient"); loc != -1)
-            glUniform4fv(loc, 1, &mat.cAmbient[0]);
-        if (GLint loc = glGetUniformLocation(m_shader, "matDiffuse"); loc != -1)
-            glUniform4fv(loc, 1, &mat.cDiffuse[0]);
-        if (GLint loc = glGetUniformLocation(m_shader, "matSpecular"); loc != -1)
-            glUniform4fv(loc, 1, &mat.cSpecular[0]);
-        if (GLint loc = glGetUniformLocation(m_shader, "matEmissive"); loc != -1)
-            glUniform4fv(loc, 1, &mat.cEmissive[0]);
-        if (GLint loc = glGetUniformLocation(m_shader, "matShininess"); loc != -1)
-            glUniform1f(loc, mat.shininess);
-
-        bool useBackgroundTex = false;
-        bool restoreCull = false;
-        if (shapeData.primitive.type == PrimitiveType::PRIMITIVE_SPHERE && m_backgroundTex != 0) {
-            float approxScale = glm::length(glm::vec3(shapeData.ctm[0]));
-            if (approxScale > 10.f) {
-                useBackgroundTex = true;
-            }
-        }
-        if (GLint loc = glGetUniformLocation(m_shader, "useBackgroundTex"); loc != -1) {
-            glUniform1i(loc, useBackgroundTex ? 1 : 0);
-        }
-        if (uEnableStarfield != -1) {
-            glUniform1i(uEnableStarfield, useBackgroundTex ? 1 : 0);
-        }
-        if (useBackgroundTex) {
-            glActiveTexture(GL_TEXTURE5);
-            glBindTexture(GL_TEXTURE_2D, m_backgroundTex);
-            if (GLint loc = glGetUniformLocation(m_shader, "backgroundTex"); loc != -1) {
-                glUniform1i(loc, 5);
-            }
-            if (glIsEnabled(GL_CULL_FACE)) {
-                glDisable(GL_CULL_FACE);
-                restoreCull = true;
-            }
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(GL_FALSE);
-        } else {
-            glActiveTexture(GL_TEXTURE5);
-            glBindTexture(GL_TEXTURE_2D, 0);
-        }
-
-        // ANIMATION: get animated transform
-        glm::mat4 model = m_animationDirector.getTransform(i);
-        if (GLint loc = glGetUniformLocation(m_shader, "model"); loc != -1)
-            glUniformMatrix4fv(loc, 1, GL_FALSE, &model[0][0]);
-
-        glDrawArrays(GL_TRIANGLES, 0, m_vboSizes[i]);
-
-        if (useBackgroundTex) {
-            if (restoreCull) {
-                glEnable(GL_CULL_FACE);
-            }
-            glDepthMask(GL_TRUE);
-            glEnable(GL_DEPTH_TEST);
-            glActiveTexture(GL_TEXTURE5);
-            glBindTexture(GL_TEXTURE_2D, 0);
-            glActiveTexture(GL_TEXTURE0);
+        // Instancing: the whole run is drawn at its first shape, then skipped
+        if (i < m_shapeBatch.size() && m_shapeBatch[i] >= 0) {
+            InstanceBatch &batch = m_instanceBatches[m_shapeBatch[i]];
+            if (uEnableStarfield != -1) glUniform1i(uEnableStarfield, 0);
+            drawInstanceBatch(batch);
+            i = batch.firstShape + batch.count - 1;
         }
-
-        glBindVertexArray(0);
+        // The sky sphere has no geometry here; renderSkyPass fills the background behind everything
     }
 
-    // 8) Unbind the shader + scene FBO before post-processing
+    // 8) Unbind the shader before post-processing
+    m_bonePalettes.fence();
     glUseProgram(0);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
-    // ========================
-    // NEW: blit FBO to screen (screen pass)
-    // ========================
+// Fullscreen background: each pixel still at the far plane gets the view ray through it, intersected
+// with the sky sphere and mapped onto the equirect texture. Depth test GL_EQUAL against the cleared
+// far plane keeps every pixel covered by geometry from being shaded.
+void Realtime::renderSkyPass() {
+    if (m_skyShape < 0 || m_backgroundTex == 0) return;
 
-    // =========================
-    // Pass 2: Bright-pass (bloom)
-    // =========================
-    glBindFramebuffer(GL_FRAMEBUFFER, m_brightFBO);
-    glViewport(0, 0, width()*m_devicePixelRatio, height()*m_devicePixelRatio);
-    glDisable(GL_DEPTH_TEST);
-    glClear(GL_COLOR_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_EQUAL);
+    glDepthMask(GL_FALSE);
 
-    glUseProgram(m_brightShader);
+    glUseProgram(m_skyShader);
+    const UniformTable &skyUniforms = ShaderLoader::uniforms(m_skyShader);
 
-    // sceneColorTex -> uScene
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_sceneColorTex);
-    glUniform1i(glGetUniformLocation(m_brightShader, "uScene"), 0);
-
-    glBindVertexArray(m_quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
-
-    // =============================
-    // Pass 2.5: Gaussian Blur (Ping-Pong)
-    // =============================
-    bool horizontal = true;
-    bool firstIter = true;
-    int blurAmount = 15;  // moderate bloom
-
-    glUseProgram(m_blurShader);
+    glBindTexture(GL_TEXTURE_2D, m_backgroundTex);
+    glUniform1i(skyUniforms.location("backgroundTex"), 0);
 
-    if (GLint loc = glGetUniformLocation(m_blurShader, "blurRadius"); loc != -1) {
-        glUniform1f(loc, 0.9f); // smaller blur kernel
+    if (GLint loc = skyUniforms.location("invViewProj"); loc != -1) {
+        glm::mat4 inv = glm::inverse(m_currViewProj);
+        glUniformMatrix4fv(loc, 1, GL_FALSE, &inv[0][0]);
     }
-
-    // if blur amount is even, use pong; if blur amount is odd, use ping
-    for (int i = 0; i < blurAmount; i++) {
-
-        glBindFramebuffer(GL_FRAMEBUFFER, horizontal ? m_pingFBO : m_pongFBO);
-
-        glUniform1i(glGetUniformLocation(m_blurShader, "horizontal"), horizontal);
-
-        glActiveTexture(GL_TEXTURE0);
-
-        // first iteration uses brightTex
-        GLuint tex = firstIter ? m_brightTex :
-                         (horizontal ? m_pongTex : m_pingTex);
-
-        glBindTexture(GL_TEXTURE_2D, tex);
-        glUniform1i(glGetUniformLocation(m_blurShader, "image"), 0);
-
-        glBindVertexArray(m_quadVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-
-        horizontal = !horizontal;
-        if (firstIter) firstIter = false;
+    // ANIMATION: the sphere's animated transform places it (centre, radius); the unit sphere
+    // primitive has radius SPHERE_RADIUS = 0.5
+    if (GLint loc = skyUniforms.location("skySphere"); loc != -1) {
+        glm::mat4 sky = m_animationDirector.getTransform(m_skyShape);
+        glUniform4f(loc, sky[3].x, sky[3].y, sky[3].z, 0.5f * glm::length(glm::vec3(sky[0])));
     }
 
-    // =========================
-    // Pass 3: Combine (scene + bloom)
-    // =========================
-    glBindFramebuffer(GL_FRAMEBUFFER, screenFBO);
-    glViewport(0, 0, width()*m_devicePixelRatio, height()*m_devicePixelRatio);
-    glDisable(GL_DEPTH_TEST);
-    glClear(GL_COLOR_BUFFER_BIT);
+    glBindVertexArray(m_skyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
 
-    glUseProgram(m_screenShader);
+    glDepthMask(GL_TRUE);
+    glDepthFunc(GL_LESS);
+    glUseProgram(0);
+}
 
-    // motion vector for screen-space blur (G-buffer depth + camera/fish motion)
-    glm::vec3 currentCamPos = glm::vec3(m_renderData.cameraData.pos);
-    if (m_animationDirector.isCameraAnimated()) {
-        currentCamPos = glm::vec3(view[3]); // extract translation from view^-1? view is not inverted
-        // fallback: use render data pos when animated
-        currentCamPos = glm::vec3(m_renderData.cameraData.pos);
+// One step down the bloom chain; the first one also applies the bright threshold
+void Realtime::bloomDownsamplePass(GLuint source, bool prefilter) {
+    glDisable(GL_DEPTH_TEST);
+    glUseProgram(m_bloomDownShader);
+    const UniformTable &downUniforms = ShaderLoader::uniforms(m_bloomDownShader);
+    glUniform1i(downUniforms.location("source"), 0);
+    if (GLint loc = downUniforms.location("threshold"); loc != -1) {
+        glUniform1f(loc, 0.7f);
     }
-    glm::vec2 camDelta = glm::vec2(currentCamPos.x - m_prevCamPos.x,
-                                   currentCamPos.z - m_prevCamPos.z);
-    float bgDelta = m_bgScrollOffset - m_prevBgScrollOffset;
-
-    glm::vec2 motionVec(0.f);
-    float camLen = glm::length(camDelta);
-    if (!m_firstFrame && camLen > 1e-5f) {
-        // only blur when camera moves; background scroll alone won't blur
-        motionVec = camDelta * 0.02f + glm::vec2(bgDelta * 1.8f, 0.0f);
+    if (GLint loc = downUniforms.location("prefilter"); loc != -1) {
+        glUniform1i(loc, prefilter ? 1 : 0);
     }
 
-    // fish screen-space velocity contribution removed (only camera-based)
-    m_prevFishUVValid = false;
-
-    // per-pixel velocity via depth (current vs prev view-projection)
-    // sample depth
-    glActiveTexture(GL_TEXTURE2);
-    glBindTexture(GL_TEXTURE_2D, m_sceneDepthTex);
-
-    float motionLen = glm::length(motionVec) * 0.5f; // overall soften
-    if (motionLen < 0.002f) {
-        motionVec = glm::vec2(0.f);
-        motionLen = 0.f;
-    }
-    glm::vec2 motionDir = motionLen > 1e-5f ? motionVec / motionLen : glm::vec2(0.f);
-    float motionAmount = glm::clamp(motionLen, 0.f, 0.03f); // softer cap
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, source);
+    glBindVertexArray(m_quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+}
 
-    // gate: only enable blur after fish eaten
-    bool blurEnabled = m_animationDirector.isFishEaten();
-    if (!blurEnabled) {
-        motionDir = glm::vec2(0.f);
-        motionAmount = 0.f;
+// Tent-filter `source` and add it onto the bound (next larger) level
+void Realtime::bloomUpsamplePass(GLuint source) {
+    glDisable(GL_DEPTH_TEST);
+    glUseProgram(m_bloomUpShader);
+    const UniformTable &upUniforms = ShaderLoader::uniforms(m_bloomUpShader);
+    glUniform1i(upUniforms.location("source"), 0);
+    if (GLint loc = upUniforms.location("filterRadius"); loc != -1) {
+        glUniform1f(loc, 1.0f);
     }
 
-    // sceneTex
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_sceneColorTex);
-    glUniform1i(glGetUniformLocation(m_screenShader, "sceneTex"), 0);
-
-    // bloomTexFinal (chosse from ping/pong)
-    GLuint bloomTexFinal = (blurAmount % 2 == 0 ? m_pongTex : m_pingTex);
+    glBindTexture(GL_TEXTURE_2D, source);
+    glBindVertexArray(m_quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+}
 
-    // bloomTex
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, bloomTexFinal);
-    glUniform1i(glGetUniformLocation(m_screenShader, "bloomTex"), 1);
+// Depth-aware screen-space motion blur of the HDR scene
+void Realtime::motionBlurPass(GLuint sceneTex, GLuint depthTex, glm::vec2 motionDir, float motionAmount) {
+    glDisable(GL_DEPTH_TEST);
+    glUseProgram(m_motionBlurShader);
+    const UniformTable &blurUniforms = ShaderLoader::uniforms(m_motionBlurShader);
 
-    if (GLint loc = glGetUniformLocation(m_screenShader, "bloomStrength"); loc != -1) {
-        glUniform1f(loc, settings.bloomStrength);
+    // per-pixel velocity via depth (current vs prev view-projection)
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, sceneTex);
+    glUniform1i(blurUniforms.location("sceneTex"), 0);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, depthTex);
+    if (GLint loc = blurUniforms.location("depthTex"); loc != -1) {
+        glUniform1i(loc, 2);
     }
-    if (GLint loc = glGetUniformLocation(m_screenShader, "motionUV"); loc != -1) {
+
+    if (GLint loc = blurUniforms.location("motionUV"); loc != -1) {
         glUniform2f(loc, motionDir.x, motionDir.y);
     }
-    if (GLint loc = glGetUniformLocation(m_screenShader, "motionAmount"); loc != -1) {
+    if (GLint loc = blurUniforms.location("motionAmount"); loc != -1) {
         glUniform1f(loc, motionAmount);
     }
-    if (GLint loc = glGetUniformLocation(m_screenShader, "depthTex"); loc != -1) {
-        glUniform1i(loc, 2);
-    }
-    if (GLint loc = glGetUniformLocation(m_screenShader, "currViewProjInv"); loc != -1) {
+    if (GLint loc = blurUniforms.location("currViewProjInv"); loc != -1) {
         glm::mat4 inv = glm::inverse(m_currViewProj);
         glUniformMatrix4fv(loc, 1, GL_FALSE, &inv[0][0]);
     }
-    if (GLint loc = glGetUniformLocation(m_screenShader, "prevViewProj"); loc != -1) {
+    if (GLint loc = blurUniforms.location("prevViewProj"); loc != -1) {
         glUniformMatrix4fv(loc, 1, GL_FALSE, &m_prevViewProj[0][0]);
     }
-    if (GLint loc = glGetUniformLocation(m_screenShader, "blurEnabled"); loc != -1) {
-        glUniform1i(loc, blurEnabled ? 1 : 0);
-    }
 
     glBindVertexArray(m_quadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
     glBindVertexArray(0);
-
-    // update history for next frame
-    m_prevCamPos = currentCamPos;
-    m_prevBgScrollOffset = m_bgScrollOffset;
-    m_firstFrame = false;
-    m_prevViewProj = m_currViewProj;
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
 }
 
-void Realtime::resizeGL(int w, int h) {
-    glViewport(0, 0, w * m_devicePixelRatio, h * m_devicePixelRatio);
+// Scene + bloom, exposed and tonemapped into the bound screen framebuffer. A scene rendered at
+// sceneScale < 1 is upscaled bilinearly and sharpened in proportion to the missing resolution.
+void Realtime::compositePass(GLuint sceneTex, GLuint bloomTex, float sceneScale) {
+    glDisable(GL_DEPTH_TEST);
+    glClear(GL_COLOR_BUFFER_BIT);
 
-    int W = w * m_devicePixelRatio;
-    int H = h * m_devicePixelRatio;
+    glUseProgram(m_screenShader);
+    const UniformTable &screenUniforms = ShaderLoader::uniforms(m_screenShader);
 
-    // scene FBO
-    glBindTexture(GL_TEXTURE_2D, m_sceneColorTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, W, H, 0,
-                 GL_RGBA, GL_FLOAT, NULL);
+    // sceneTex
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, sceneTex);
+    glUniform1i(screenUniforms.location("sceneTex"), 0);
 
-    // bright FBO
-    glBindTexture(GL_TEXTURE_2D, m_brightTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, W, H, 0,
-                 GL_RGBA, GL_FLOAT, NULL);
+    // bloomTex: the top of the chain, upsampled by the linear filter
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, bloomTex);
+    glUniform1i(screenUniforms.location("bloomTex"), 1);
 
-    // blur FBOs
-    glBindTexture(GL_TEXTURE_2D, m_pingTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, W, H, 0,
-                 GL_RGBA, GL_FLOAT, NULL);
+    // Every level adds roughly the bright-pass energy once, so divide it back out
+    if (GLint loc = screenUniforms.location("bloomStrength"); loc != -1) {
+        glUniform1f(loc, settings.bloomStrength / kBloomLevels);
+    }
+    if (GLint loc = screenUniforms.location("exposure"); loc != -1) {
+        glUniform1f(loc, settings.exposure);
+    }
+    if (GLint loc = screenUniforms.location("sharpness"); loc != -1) {
+        glUniform1f(loc, glm::clamp((1.f - sceneScale) * 2.f, 0.f, 1.f) * kUpscaleSharpness);
+    }
 
-    glBindTexture(GL_TEXTURE_2D, m_pongTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, W, H, 0,
-                 GL_RGBA, GL_FLOAT, NULL);
+    glBindVertexArray(m_quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+    glUseProgram(0);
+}
 
-    // depth texture
-    glBindTexture(GL_TEXTURE_2D, m_sceneDepthTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, W, H, 0,
-                 GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+void Realtime::resizeGL(int w, int h) {
+    glViewport(0, 0, w * m_devicePixelRatio, h * m_devicePixelRatio);
+
+    // Post-processing targets follow on their next use
+    m_renderGraph.setOutputSize(w * m_devicePixelRatio, h * m_devicePixelRatio);
 }
 
 void Realtime::sceneChanged() {
@@ -779,126 +825,206 @@ void Realtime::buildVAOsFromRenderData()
 {
     makeCurrent();
 
-    // clean old VAO / VBO
-    for (GLuint vao : m_vaos) {
-        glDeleteVertexArrays(1, &vao);
-    }
-    for (GLuint vbo : m_vbos) {
-        glDeleteBuffers(1, &vbo);
-    }
-    m_vaos.clear();
-    m_vbos.clear();
-    m_vboSizes.clear();
+    // clean old instance batches
+    deleteInstanceBatches();
+    m_geometryCache.beginBuild();
 
     // For monster
     m_meshFiles.clear();
     m_meshFiles.reserve(m_renderData.shapes.size());
+    m_glbPoses.assign(m_renderData.shapes.size(), GLBPose{});
+    m_glbPaletteSource.resize(m_renderData.shapes.size());
+    std::iota(m_glbPaletteSource.begin(), m_glbPaletteSource.end(), size_t(0));
+    m_glbInstances.clear();
+
+    m_shapeBatch.assign(m_renderData.shapes.size(), -1);
+    m_skyShape = -1;
 
-    // generate a VAO + VBO for each primitive
-    for (const RenderShapeData &shape : m_renderData.shapes)
+    // batch the primitives
+    for (size_t i = 0; i < m_renderData.shapes.size(); ++i)
     {
+        const RenderShapeData &shape = m_renderData.shapes[i];
+
         // For monster
         m_meshFiles.emplace_back();   // place a placeholder to ensure index consistency
 
         if (shape.primitive.type == PrimitiveType::PRIMITIVE_MESH) {
             std::string resolved = resolveMeshPath(shape.primitive.meshfile);
             m_meshFiles.back() = resolved;
-            if (!resolved.empty() && !ensureGlbModelLoaded(resolved)) {
-                std::cerr << "Failed to load GLB: " << resolved << std::endl;
+            if (!resolved.empty()) {
+                requestGlbModel(resolved);   // parsed on a worker, uploaded from paintGL
+                m_glbInstances[resolved].push_back(i);
             }
 
-            m_vaos.push_back(0);   // Placeholder: The actual VAO has already been created in GLBLoader
-            m_vbos.push_back(0);
-            m_vboSizes.push_back(0);
-            continue;              // No more vertex data is generated
+            continue;              // The VAOs are created by GLBLoader::uploadGLB
         }
 
-
-        std::vector<float> vertexData;
-
-        // ---- generates vertex normal data of the primitive type ----
-        switch (shape.primitive.type) {
-        case PrimitiveType::PRIMITIVE_CUBE:
-            m_cube.updateParams(settings.shapeParameter1);
-            vertexData = m_cube.generateShape();
-            break;
-        case PrimitiveType::PRIMITIVE_SPHERE:
-            m_sphere.updateParams(settings.shapeParameter1,
-                                  settings.shapeParameter2);
-            vertexData = m_sphere.generateShape();
-            break;
-        case PrimitiveType::PRIMITIVE_CONE:
-            m_cone.updateParams(settings.shapeParameter1,
-                                settings.shapeParameter2);
-            vertexData = m_cone.generateShape();
-            break;
-        case PrimitiveType::PRIMITIVE_CYLINDER:
-            m_cylinder.updateParams(settings.shapeParameter1,
-                                    settings.shapeParameter2);
-            vertexData = m_cylinder.generateShape();
-            break;
-        case PrimitiveType::PRIMITIVE_STAR:
-            m_star.updateParams(settings.shapeParameter1,
-                                settings.shapeParameter2);
-            vertexData = m_star.generateShape();
-            break;
-        default:
+        // Instancing: extend the previous run if this shape shares its mesh and specular material,
+        // otherwise open a new batch. Only the sky sphere stays out of the batches.
+        if (!isSkyShape(shape)) {
+            bool extendsRun = false;
+            if (i > 0 && m_shapeBatch[i - 1] >= 0) {
+                const InstanceBatch &prev = m_instanceBatches[m_shapeBatch[i - 1]];
+                const SceneMaterial &first = m_renderData.shapes[prev.firstShape].primitive.material;
+                extendsRun = prev.type == shape.primitive.type &&
+                             first.cSpecular == shape.primitive.material.cSpecular &&
+                             first.shininess == shape.primitive.material.shininess;
+            }
+            if (extendsRun) {
+                m_instanceBatches.back().count++;
+            } else {
+                InstanceBatch batch;
+                batch.type = shape.primitive.type;
+                batch.firstShape = i;
+                batch.count = 1;
+                m_instanceBatches.push_back(std::move(batch));
+            }
+            m_shapeBatch[i] = static_cast<int>(m_instanceBatches.size()) - 1;
             continue;
         }
 
-        if (vertexData.empty()) {
-            // For monster
-            m_vaos.push_back(0);
-            m_vbos.push_back(0);
-            m_vboSizes.push_back(0);
-
-            continue;
-        }
+        // The sky sphere: drawn as a fullscreen background pass instead of a tessellated sphere
+        if (m_skyShape < 0) m_skyShape = static_cast<int>(i);
+    }
 
-        // ---- create and bind VAO / VBO ----
-        GLuint vao, vbo;
-        glGenVertexArrays(1, &vao);
-        glGenBuffers(1, &vbo);
+    for (InstanceBatch &batch : m_instanceBatches) {
+        uploadInstanceBatch(batch);
+    }
 
-        glBindVertexArray(vao);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    // release meshes for tessellations no shape uses any more (e.g. after a settings change)
+    m_geometryCache.evictUnused();
+}
 
-        glBufferData(GL_ARRAY_BUFFER,
-                     sizeof(float) * vertexData.size(),
-                     vertexData.data(),
-                     GL_STATIC_DRAW);
+// Geometry cache lookup with the current tessellation settings
+const CachedMesh *Realtime::acquirePrimitiveMesh(PrimitiveType type)
+{
+    return m_geometryCache.acquire(type, settings.shapeParameter1, settings.shapeParameter2);
+}
 
-        int stride = 6 * sizeof(float);   // 3 pos + 3 normal
+// The sky is the large background sphere; the background pass maps the equirect texture onto it
+bool Realtime::isSkyShape(const RenderShapeData &shape) const
+{
+    if (shape.primitive.type != PrimitiveType::PRIMITIVE_SPHERE || m_backgroundTex == 0) {
+        return false;
+    }
+    float approxScale = glm::length(glm::vec3(shape.ctm[0]));
+    return approxScale > 10.f;
+}
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-                              stride, (void*)0);
+void Realtime::uploadInstanceBatch(InstanceBatch &batch)
+{
+    batch.mesh = acquirePrimitiveMesh(batch.type);
+    if (!batch.mesh || batch.count == 0) {
+        return;
+    }
 
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+    // per-instance data starts from the scene ctm; animated shapes are refreshed in drawInstanceBatch
+    batch.instanceData.resize(batch.count * kInstanceFloats);
+    for (size_t k = 0; k < batch.count; ++k) {
+        const RenderShapeData &shape = m_renderData.shapes[batch.firstShape + k];
+        float *dst = &batch.instanceData[k * kInstanceFloats];
+        std::memcpy(dst,      &shape.ctm[0][0], 16 * sizeof(float));
+        std::memcpy(dst + 16, &shape.primitive.material.cEmissive[0], 4 * sizeof(float));
+        std::memcpy(dst + 20, &shape.primitive.material.cDiffuse[0], 4 * sizeof(float));
+        std::memcpy(dst + 24, &shape.primitive.material.cAmbient[0], 4 * sizeof(float));
+    }
 
-        // For monster
-        // Give the constant value of attribute 2/3/4
-        glDisableVertexAttribArray(2);
-        glVertexAttribI4i(2, 0, 0, 0, 0);
+    glGenVertexArrays(1, &batch.vao);
+    glGenBuffers(1, &batch.instanceVbo);
 
-        glDisableVertexAttribArray(3);
-        glVertexAttrib4f(3, 1.f, 0.f, 0.f, 0.f);
+    glBindVertexArray(batch.vao);
 
-        glDisableVertexAttribArray(4);
-        glVertexAttrib2f(4, 0.f, 0.f);
+    // shared mesh
+    glBindBuffer(GL_ARRAY_BUFFER, batch.mesh->vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.mesh->ebo);   // recorded in the VAO
 
+    int stride = 6 * sizeof(float);   // 3 pos + 3 normal
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+
+    // For monster: constant skinning / uv attributes
+    glDisableVertexAttribArray(2);
+    glVertexAttribI4i(2, 0, 0, 0, 0);
+    glDisableVertexAttribArray(3);
+    glVertexAttrib4f(3, 1.f, 0.f, 0.f, 0.f);
+    glDisableVertexAttribArray(4);
+    glVertexAttrib2f(4, 0.f, 0.f);
+
+    // per-instance attributes, advanced once per instance
+    glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER,
+                 sizeof(float) * batch.instanceData.size(),
+                 batch.instanceData.data(),
+                 GL_DYNAMIC_DRAW);
+
+    int instanceStride = kInstanceFloats * sizeof(float);
+    for (GLuint col = 0; col < 4; ++col) {
+        glEnableVertexAttribArray(kInstanceModelLoc + col);
+        glVertexAttribPointer(kInstanceModelLoc + col, 4, GL_FLOAT, GL_FALSE, instanceStride,
+                              (void*)(col * 4 * sizeof(float)));
+        glVertexAttribDivisor(kInstanceModelLoc + col, 1);
+    }
+    glEnableVertexAttribArray(kInstanceEmissiveLoc);
+    glVertexAttribPointer(kInstanceEmissiveLoc, 4, GL_FLOAT, GL_FALSE, instanceStride, (void*)(16 * sizeof(float)));
+    glVertexAttribDivisor(kInstanceEmissiveLoc, 1);
+    glEnableVertexAttribArray(kInstanceDiffuseLoc);
+    glVertexAttribPointer(kInstanceDiffuseLoc, 4, GL_FLOAT, GL_FALSE, instanceStride, (void*)(20 * sizeof(float)));
+    glVertexAttribDivisor(kInstanceDiffuseLoc, 1);
+    glEnableVertexAttribArray(kInstanceAmbientLoc);
+    glVertexAttribPointer(kInstanceAmbientLoc, 4, GL_FLOAT, GL_FALSE, instanceStride, (void*)(24 * sizeof(float)));
+    glVertexAttribDivisor(kInstanceAmbientLoc, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
 
-        // ---- unbind ----
+void Realtime::drawInstanceBatch(InstanceBatch &batch)
+{
+    if (batch.vao == 0 || !batch.mesh) return;
+
+    // ANIMATION: only shapes with a path animation move; everything else keeps its ctm
+    bool dirty = false;
+    for (size_t k = 0; k < batch.count; ++k) {
+        size_t shapeIndex = batch.firstShape + k;
+        if (!m_animationDirector.hasPathAnimation(shapeIndex)) continue;
+        glm::mat4 model = m_animationDirector.getTransform(shapeIndex);
+        std::memcpy(&batch.instanceData[k * kInstanceFloats], &model[0][0], 16 * sizeof(float));
+        dirty = true;
+    }
+    if (dirty) {
+        glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVbo);
+        glBufferSubData(GL_ARRAY_BUFFER, 0,
+                        sizeof(float) * batch.instanceData.size(),
+                        batch.instanceData.data());
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+    }
 
-        // push back
-        m_vaos.push_back(vao);
-        m_vbos.push_back(vbo);
-        m_vboSizes.push_back(static_cast<int>(vertexData.size() / 6));
+    // specular terms are shared by the whole run; the rest comes from the instance buffer
+    const SceneMaterial &mat = m_renderData.shapes[batch.firstShape].primitive.material;
+    if (m_uniforms.matSpecular != -1)      glUniform4fv(m_uniforms.matSpecular, 1, &mat.cSpecular[0]);
+    if (m_uniforms.matShininess != -1)     glUniform1f(m_uniforms.matShininess, mat.shininess);
+
+    GLint locUseInstancing = m_uniforms.useInstancing;
+    if (locUseInstancing != -1) glUniform1i(locUseInstancing, 1);
+
+    glBindVertexArray(batch.vao);
+    glDrawElementsInstanced(GL_TRIANGLES, batch.mesh->indexCount, batch.mesh->indexType, nullptr,
+                            static_cast<GLsizei>(batch.count));
+    glBindVertexArray(0);
 
+    if (locUseInstancing != -1) glUniform1i(locUseInstancing, 0);
+}
+
+void Realtime::deleteInstanceBatches()
+{
+    for (InstanceBatch &batch : m_instanceBatches) {
+        if (batch.instanceVbo) glDeleteBuffers(1, &batch.instanceVbo);
+        if (batch.vao) glDeleteVertexArrays(1, &batch.vao);
     }
+    m_instanceBatches.clear();
+    m_shapeBatch.clear();
 }
 
 
@@ -913,7 +1039,30 @@ void Realtime::settingsChanged() {
 
 void Realtime::timerEvent(QTimerEvent *event) {
     Q_UNUSED(event);
-    float deltaSec = m_elapsedTimer.restart() * 0.001f;
+    syncProfilerSettings();
+    FrameProfiler::CpuScope tickScope(m_profiler, "timerEvent");
+
+    advanceTime(m_elapsedTimer.restart() * 0.001f);
+
+    // Refresh the overlay a few times a second; per-frame text churn is unreadable anyway
+    if (settings.showProfiler && m_overlayRefreshTimer.elapsed() > 250) {
+        m_overlayRefreshTimer.restart();
+        std::string overlay = m_profiler.overlayText();
+        if (m_dynamicResolution.enabled()) {
+            char line[64];
+            std::snprintf(line, sizeof(line), "\nscene scale %.2f (gpu %.1f ms)",
+                          m_dynamicResolution.scale(), m_dynamicResolution.gpuMs());
+            overlay += line;
+        }
+        m_profilerOverlay->setText(QString::fromStdString(overlay));
+        m_profilerOverlay->adjustSize();
+    }
+
+    update();
+}
+
+// Step every time-driven system (scroll, director, skeletal clips) by an explicit timestep
+void Realtime::advanceTime(float deltaSec) {
     m_scrollTime += deltaSec;
     m_bgScrollOffset += deltaSec * settings.bgScrollSpeed;
     if (m_bgScrollOffset >= 1.f) {
@@ -923,13 +1072,44 @@ void Realtime::timerEvent(QTimerEvent *event) {
     }
 
     // ANIMATION: update animation director
-    m_animationDirector.update(deltaSec);
+    {
+        FrameProfiler::CpuScope scope(m_profiler, "director");
+        m_animationDirector.update(deltaSec);
+    }
 
     // For monster: Promote skeletal animation
-    updateGlbAnimations(deltaSec);
+    {
+        FrameProfiler::CpuScope scope(m_profiler, "glbAnims");
+        updateGlbAnimations(deltaSec);
+    }
+}
 
+void Realtime::initializeOffscreen(GLuint targetFBO, int width, int height) {
+    m_offscreen = true;
+    m_offscreenFBO = targetFBO;
+    resize(width, height);   // hidden widget: geometry applies immediately, no resize event needed
+    initializeGL();
+}
 
-    update();
+void Realtime::renderFrame() {
+    paintGL();
+}
+
+// Follow the profiler checkboxes: overlay visibility and CSV target live in settings
+void Realtime::syncProfilerSettings() {
+    const bool wantCsv = !settings.profilerCsvPath.empty();
+    if (wantCsv && m_profiler.csvPath() != settings.profilerCsvPath) {
+        if (!m_profiler.openCsv(settings.profilerCsvPath)) {
+            settings.profilerCsvPath.clear();   // don't retry every tick
+        }
+    } else if (!wantCsv && !m_profiler.csvPath().empty()) {
+        m_profiler.closeCsv();
+    }
+
+    m_profiler.setEnabled(settings.showProfiler || !settings.profilerCsvPath.empty());
+    if (m_profilerOverlay->isVisible() != settings.showProfiler) {
+        m_profilerOverlay->setVisible(settings.showProfiler);
+    }
 }
 
 // ================== Camera Movement! ---- Not needed
@@ -1068,7 +1248,80 @@ void Realtime::saveViewportImage(std::string filePath) {
 
 void Realtime::setSceneFilePath(std::string path) { m_sceneFilePath = path; }
 
+void Realtime::startRecording(const std::string &directory) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        std::cerr << "Cannot record to " << directory << ": " << ec.message() << std::endl;
+        return;
+    }
+    m_recordDirectory = directory;
+    m_recordFrame = 0;
+    m_recording = true;
+    std::cout << "Recording frames to " << directory << std::endl;
+}
 
+void Realtime::stopRecording() {
+    if (!m_recording) return;
+    m_recording = false;
+
+    // Drain the readback ring and encoders so the sequence is complete on disk
+    makeCurrent();
+    m_capture.flush();
+    doneCurrent();
+    std::cout << "Recorded " << m_recordFrame << " frames (" << m_capture.failures()
+              << " failed) to " << m_recordDirectory << std::endl;
+}
+
+
+
+// For monster: write the palette of every visible skinned instance into this frame's buffer slot.
+// Instances sharing a palette (see updateGlbAnimations) share its rows too.
+void Realtime::uploadBonePalettes() {
+    m_boneOffsets.assign(m_meshFiles.size(), -1);
+    m_sourceOffsets.assign(m_meshFiles.size(), -1);
+
+    size_t totalRows = 0;
+    for (size_t i = 0; i < m_meshFiles.size() && i < m_glbPoses.size(); ++i) {
+        if (m_meshFiles[i].empty() || !m_animationDirector.isShapeVisible(i)) continue;
+        auto it = m_glbModels.find(m_meshFiles[i]);
+        if (it == m_glbModels.end() || !it->second.loaded || !it->second.hasSkin) continue;
+
+        // The source is another instance of the same model (indices may be stale after a reload)
+        size_t source = i < m_glbPaletteSource.size() ? m_glbPaletteSource[i] : i;
+        if (source >= m_glbPoses.size() || m_meshFiles[source] != m_meshFiles[i]) source = i;
+
+        GLBPose &pose = m_glbPoses[source];
+        if (pose.palette.empty()) {
+            GLBLoader::updateAnimation(it->second, pose, GLBClipLayer{}); // not animated yet: bind pose
+        }
+        if (pose.palette.empty()) continue;
+        m_boneOffsets[i] = static_cast<int>(source);   // source of the shape, resolved to an offset below
+        if (m_sourceOffsets[source] < 0) {
+            m_sourceOffsets[source] = 0;   // marks the source for the write pass below
+            totalRows += pose.palette.size();
+        }
+    }
+    if (totalRows == 0 || !m_bonePalettes.begin(totalRows)) {
+        std::fill(m_boneOffsets.begin(), m_boneOffsets.end(), -1);
+        return;
+    }
+
+    for (size_t i = 0; i < m_sourceOffsets.size(); ++i) {
+        if (m_sourceOffsets[i] < 0) continue;
+        const GLBPose &pose = m_glbPoses[i];
+        m_sourceOffsets[i] = m_bonePalettes.write(pose.palette.data(), pose.palette.size());
+    }
+    for (int &offset : m_boneOffsets) {
+        if (offset >= 0) offset = m_sourceOffsets[offset];
+    }
+    m_bonePalettes.end();
+
+    m_bonePalettes.bind(kBonePaletteUnit);
+    if (m_uniforms.boneTexture != -1) {
+        glUniform1i(m_uniforms.boneTexture, kBonePaletteUnit - GL_TEXTURE0);
+    }
+}
 
 // For monster
 void Realtime::drawMeshPrimitive(size_t shapeIndex, const RenderShapeData &shape) {
@@ -1083,18 +1336,19 @@ void Realtime::drawMeshPrimitive(size_t shapeIndex, const RenderShapeData &shape
 
     auto it = m_glbModels.find(meshfile);
     if (it == m_glbModels.end() || !it->second.loaded) return;
-    GLBModel &model = it->second;
-
-    GLint locModel         = glGetUniformLocation(m_shader, "model");
-    GLint locUseMeshTex    = glGetUniformLocation(m_shader, "useMeshTexture");
-    GLint locMeshTex       = glGetUniformLocation(m_shader, "meshTexture");
-    GLint locUseNormalMap  = glGetUniformLocation(m_shader, "useNormalMap");
-    GLint locNormalMapTex  = glGetUniformLocation(m_shader, "normalMapTexture");
-    GLint locMeshEmissive  = glGetUniformLocation(m_shader, "meshEmissive");
-    GLint locUseEmissiveTex = glGetUniformLocation(m_shader, "useMeshEmissiveTex");
-    GLint locEmissiveTex   = glGetUniformLocation(m_shader, "meshEmissiveTex");
-    GLint locUseSkinning   = glGetUniformLocation(m_shader, "useSkinning");
-    GLint locBoneMatrices  = glGetUniformLocation(m_shader, "boneMatrices[0]");
+    const GLBModel &model = it->second;
+    const int boneOffset = shapeIndex < m_boneOffsets.size() ? m_boneOffsets[shapeIndex] : -1;
+
+    GLint locModel         = m_uniforms.model;
+    GLint locUseMeshTex    = m_uniforms.useMeshTexture;
+    GLint locMeshTex       = m_uniforms.meshTexture;
+    GLint locUseNormalMap  = m_uniforms.useNormalMap;
+    GLint locNormalMapTex  = m_uniforms.normalMapTexture;
+    GLint locMeshEmissive  = m_uniforms.meshEmissive;
+    GLint locUseEmissiveTex = m_uniforms.useMeshEmissiveTex;
+    GLint locEmissiveTex   = m_uniforms.meshEmissiveTex;
+    GLint locUseSkinning   = m_uniforms.useSkinning;
+    GLint locBoneOffset    = m_uniforms.boneOffset;
 
     // New: rotate the model
     // glm::mat4 modelMatrix = shape.ctm;
@@ -1137,18 +1391,13 @@ void Realtime::drawMeshPrimitive(size_t shapeIndex, const RenderShapeData &shape
         glUniformMatrix4fv(locModel, 1, GL_FALSE, &modelMatrix[0][0]);
     }
 
-    bool hasSkinning = model.hasSkin && !model.skin.boneMatrices.empty();
+    // The palette is already in the frame's buffer; the meshes only need its offset
+    bool hasSkinning = model.hasSkin && boneOffset >= 0;
     if (locUseSkinning != -1) {
         glUniform1i(locUseSkinning, hasSkinning ? 1 : 0);
     }
-    if (hasSkinning && locBoneMatrices != -1) {
-        GLsizei boneCount = std::min<int>(model.skin.boneMatrices.size(), 200);
-        if (boneCount > 0) {
-            glUniformMatrix4fv(locBoneMatrices,
-                               boneCount,
-                               GL_FALSE,
-                               &model.skin.boneMatrices[0][0][0]);
-        }
+    if (hasSkinning && locBoneOffset != -1) {
+        glUniform1i(locBoneOffset, boneOffset);
     }
 
     for (const GLBMesh &mesh : model.meshes) {
@@ -1168,16 +1417,11 @@ void Realtime::drawMeshPrimitive(size_t shapeIndex, const RenderShapeData &shape
             mat.shininess = glbMaterial->shininess;
         }
 
-        if (GLint loc = glGetUniformLocation(m_shader, "matAmbient"); loc != -1)
-            glUniform4fv(loc, 1, &mat.cAmbient[0]);
-        if (GLint loc = glGetUniformLocation(m_shader, "matDiffuse"); loc != -1)
-            glUniform4fv(loc, 1, &mat.cDiffuse[0]);
-        if (GLint loc = glGetUniformLocation(m_shader, "matSpecular"); loc != -1)
-            glUniform4fv(loc, 1, &mat.cSpecular[0]);
-        if (GLint loc = glGetUniformLocation(m_shader, "matEmissive"); loc != -1)
-            glUniform4fv(loc, 1, &mat.cEmissive[0]);
-        if (GLint loc = glGetUniformLocation(m_shader, "matShininess"); loc != -1)
-            glUniform1f(loc, mat.shininess);
+        if (m_uniforms.matAmbient != -1)   glUniform4fv(m_uniforms.matAmbient, 1, &mat.cAmbient[0]);
+        if (m_uniforms.matDiffuse != -1)   glUniform4fv(m_uniforms.matDiffuse, 1, &mat.cDiffuse[0]);
+        if (m_uniforms.matSpecular != -1)  glUniform4fv(m_uniforms.matSpecular, 1, &mat.cSpecular[0]);
+        if (m_uniforms.matEmissive != -1)  glUniform4fv(m_uniforms.matEmissive, 1, &mat.cEmissive[0]);
+        if (m_uniforms.matShininess != -1) glUniform1f(m_uniforms.matShininess, mat.shininess);
 
         // Texture/Glow
         bool hasTexture = false;
@@ -1256,6 +1500,10 @@ void Realtime::drawMeshPrimitive(size_t shapeIndex, const RenderShapeData &shape
         }
 
         // Draw
+        // Packed meshes decode positions from their bounds; float meshes carry (1, 0)
+        if (m_uniforms.meshPosScale != -1)  glUniform3fv(m_uniforms.meshPosScale, 1, &mesh.posScale[0]);
+        if (m_uniforms.meshPosOffset != -1) glUniform3fv(m_uniforms.meshPosOffset, 1, &mesh.posOffset[0]);
+
         glBindVertexArray(mesh.vao);
         if (mesh.hasIndices && mesh.ebo != 0) {
             glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, nullptr);
@@ -1271,6 +1519,8 @@ void Realtime::drawMeshPrimitive(size_t shapeIndex, const RenderShapeData &shape
     if (locMeshEmissive != -1) glUniform3f(locMeshEmissive, 0.f, 0.f, 0.f);
     if (locUseEmissiveTex != -1) glUniform1i(locUseEmissiveTex, 0);
     if (locUseSkinning != -1) glUniform1i(locUseSkinning, 0);
+    if (m_uniforms.meshPosScale != -1)  glUniform3f(m_uniforms.meshPosScale, 1.f, 1.f, 1.f);
+    if (m_uniforms.meshPosOffset != -1) glUniform3f(m_uniforms.meshPosOffset, 0.f, 0.f, 0.f);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, 0);
     glActiveTexture(GL_TEXTURE1);
@@ -1323,24 +1573,55 @@ std::string Realtime::resolveMeshPath(const std::string &meshfile) const {
     return input.string(); // fallback
 }
 
-bool Realtime::ensureGlbModelLoaded(const std::string &meshfile) {
-    if (meshfile.empty()) return false;
+void Realtime::requestGlbModel(const std::string &meshfile) {
+    if (meshfile.empty() || m_glbModels.count(meshfile)) return;
+    m_glbLoader.request(meshfile);
+}
 
-    auto it = m_glbModels.find(meshfile);
-    if (it != m_glbModels.end() && it->second.loaded) {
-        return true;
+// Moves parsed models into m_glbModels and uploads staged data, about uploadBudget bytes per call.
+// Models are drawn once fully uploaded, so a large GLB appears a few frames late instead of
+// stalling the window.
+void Realtime::pumpGlbLoads(size_t uploadBudget) {
+    for (GLBAsyncLoader::Result &result : m_glbLoader.takeFinished()) {
+        if (!result.ok || m_glbModels.count(result.path)) continue;
+        m_glbModels[result.path] = std::move(result.model);
+        m_glbUploads.push_back(result.path);
     }
 
-    makeCurrent(); // 确保有 GL context
-    GLBModel model;
-    if (!GLBLoader::loadGLB(meshfile, model)) {
-        return false;
+    size_t done = 0;
+    while (done < m_glbUploads.size()) {
+        if (!GLBLoader::uploadGLB(m_glbModels[m_glbUploads[done]], uploadBudget)) break;
+        ++done;
     }
-    if (model.hasSkin) {
-        GLBLoader::updateAnimation(model, 0.0f, -1, false); // initialize to bind pose
+    m_glbUploads.erase(m_glbUploads.begin(), m_glbUploads.begin() + done);
+}
+
+void Realtime::finishGlbLoads() {
+    makeCurrent();
+    m_glbLoader.waitIdle();
+    pumpGlbLoads(SIZE_MAX);
+}
+
+// For monster: advance one instance's clip state and pose it. Instances of a model in the same clip
+// state (the usual case under the director, which times a model as a whole) evaluate to the same
+// palette, so only the first one is evaluated and the rest point at it via m_glbPaletteSource.
+void Realtime::poseGlbInstance(const GLBModel &model, size_t shapeIndex, const GLBClipLayer &clip, float deltaSec,
+                               bool ignoreRootTranslation) {
+    GLBPose &pose = m_glbPoses[shapeIndex];
+    GlbEvaluatedState state;
+    state.layerCount = GLBLoader::advanceClips(model, pose, clip, deltaSec, state.layers);
+    state.shapeIndex = shapeIndex;
+
+    for (const GlbEvaluatedState &evaluated : m_glbEvaluated) {
+        if (evaluated.layerCount == state.layerCount &&
+            std::equal(state.layers, state.layers + state.layerCount, evaluated.layers)) {
+            m_glbPaletteSource[shapeIndex] = evaluated.shapeIndex;
+            return;
+        }
     }
-    m_glbModels[meshfile] = std::move(model);
-    return true;
+    GLBLoader::evaluateClips(model, pose, state.layers, state.layerCount, ignoreRootTranslation);
+    m_glbPaletteSource[shapeIndex] = shapeIndex;
+    m_glbEvaluated.push_back(state);
 }
 
 void Realtime::updateGlbAnimations(float deltaSec) {
@@ -1349,6 +1630,9 @@ void Realtime::updateGlbAnimations(float deltaSec) {
     // ANIMATION: use animation director for glb animations
     for (auto &[path, model] : m_glbModels) {
         if (!model.hasSkin) continue;
+        auto instances = m_glbInstances.find(path);
+        if (instances == m_glbInstances.end()) continue;
+        m_glbEvaluated.clear();
         
         if (m_animationDirector.isGLBAnimationActive(path)) {
             // use animation director timeline
@@ -1356,131 +1640,42 @@ void Realtime::updateGlbAnimations(float deltaSec) {
             int animIndex = m_animationDirector.getGLBAnimationIndex(path);
             bool ignoreRootTrans = m_animationDirector.shouldIgnoreRootTranslation(path);
             
-            // ANIMATION: if path animation has stopped, continue GLB animation independently
-            // this ensures GLB animations (like titan's wings) continue looping even after path stops
-            static std::unordered_map<std::string, float> glbIndependentTime;
-            bool isPingPong = m_animationDirector.isGLBAnimationPingPong(path);
-            bool pathStopped = !m_animationDirector.isPlaying();
+            // ANIMATION: ping-pong plays the clip 0 -> duration -> 0 ... without looping, so the peak at
+            // duration is held instead of wrapping to 0. Such clips (like titan's wings) keep going at the
+            // director's speed after the path animation stops, from where each instance was.
+            const bool validClip = animIndex >= 0 && animIndex < static_cast<int>(model.animations.size());
+            const float duration = validClip ? model.animations[animIndex].duration : 0.f;
+            const bool pingPong = m_animationDirector.isGLBAnimationPingPong(path) && duration > 0.f;
+            const bool pathStopped = !m_animationDirector.isPlaying();
+            const float speed = m_animationDirector.getGLBAnimationSpeed(path);
             
-            if (isPingPong && pathStopped && animIndex >= 0 && animIndex < static_cast<int>(model.animations.size())) {
-                // path animation stopped, but GLB animation should continue
-                // use independent time that continues to increase
-                float duration = model.animations[animIndex].duration;
-                if (duration > 0.f) {
-                    if (glbIndependentTime.find(path) == glbIndependentTime.end()) {
-                        // initialize with current inputTime
-                        glbIndependentTime[path] = inputTime;
-                    }
-                    // continue updating independent time
-                    glbIndependentTime[path] += deltaSec * 0.2f;  // use titan's speed (0.2x)
-                    inputTime = glbIndependentTime[path];
+            // The director times a model as a whole: every instance plays the same clip time.
+            // A clip change crossfades per instance (GLBPose::crossfadeSeconds).
+            for (size_t shapeIndex : instances->second) {
+                GLBPose &pose = m_glbPoses[shapeIndex];
+                float clipTime = inputTime;
+                if (pingPong && pathStopped) {
+                    pose.continuedTime = (pose.continuedTime < 0.f ? inputTime : pose.continuedTime) + deltaSec * speed;
+                    clipTime = pose.continuedTime;
+                } else {
+                    pose.continuedTime = -1.f;
                 }
-            } else if (!pathStopped) {
-                // path animation is playing, reset independent time if it exists
-                glbIndependentTime.erase(path);
-            }
-            
-            float animTime = inputTime;  // default: use input time as-is
-            
-            // ANIMATION: apply ping-pong mode for smooth looping
-            // note: GLBLoader will mod the time by duration at line 1080
-            // so we need to pass a value that when modded gives us the ping-pong effect
-            if (m_animationDirector.isGLBAnimationPingPong(path) && 
-                animIndex >= 0 && animIndex < static_cast<int>(model.animations.size())) {
-                float duration = model.animations[animIndex].duration;
-                if (duration > 0.f) {
-                    // ping-pong: play forward then backward for smooth looping
-                    // key insight: we need to map continuous inputTime to a ping-pong cycle
-                    // cycle: 0 -> duration (forward) -> 0 (backward) -> duration (forward) ...
-                    // but GLBLoader will mod by duration, so we need to be careful
-                    
-                    // calculate position in ping-pong cycle (period = duration * 2)
+                if (pingPong) {
                     float cyclePeriod = duration * 2.f;
-                    float cycleTime = std::fmod(inputTime, cyclePeriod);
+                    float cycleTime = std::fmod(clipTime, cyclePeriod);
                     if (cycleTime < 0.f) {
                         cycleTime += cyclePeriod;
                     }
-                    
-                    // ping-pong mapping for smooth A-B-B-A looping:
-                    // forward: cycleTime in [0, duration) -> output = cycleTime (0 to duration-)
-                    // backward: cycleTime in [duration, duration*2) -> output = duration*2 - cycleTime (duration- to 0+)
-                    // key: at cycleTime = 0 or duration*2, output should be 0 (smooth loop)
-                    //      at cycleTime = duration, output should be duration (peak)
-                    
-                    float outputTime;
-                    if (cycleTime < duration) {
-                        // forward phase: [0, duration) -> [0, duration)
-                        outputTime = cycleTime;
-                    } else {
-                        // backward phase: [duration, duration*2) -> (duration, 0]
-                        // reverseTime = duration*2 - cycleTime
-                        // when cycleTime = duration: reverseTime = duration
-                        // when cycleTime -> duration*2: reverseTime -> 0
-                        outputTime = cyclePeriod - cycleTime;
-                    }
-                    
-                    // critical: GLBLoader does fmod(outputTime, duration) at line 1080
-                    // this means outputTime = duration becomes 0 (causes jump!)
-                    // we need to ensure smooth transitions at boundaries:
-                    // - at cycleTime = 0: outputTime = 0 (start of forward)
-                    // - at cycleTime = duration*2: outputTime = 0 (end of backward, loops to start)
-                    // - at cycleTime = duration: outputTime = duration (peak, but mod wraps to 0!)
-                    
-                    const float epsilon = 0.001f;  // small buffer to avoid exact boundaries
-                    
-                    // handle boundary cases to prevent jumps:
-                    // 1. when outputTime is exactly 0: keep it as 0 (smooth loop point)
-                    // 2. when outputTime is exactly duration: use duration-epsilon (avoid mod wrap)
-                    // 3. when outputTime is very close to 0 but not exactly: keep it (smooth backward end)
-                    if (outputTime >= duration - epsilon) {
-                        // near duration: use duration-epsilon to avoid mod wrap to 0
-                        outputTime = duration - epsilon;
-                    } else if (outputTime < epsilon && outputTime > 0.f) {
-                        // very close to 0 but not exactly: keep small value for smooth backward end
-                        // this ensures smooth transition when cycleTime approaches duration*2
-                        outputTime = std::max(outputTime, 0.0001f);
-                    }
-                    // if outputTime is exactly 0, keep it as 0 (this is the loop point)
-                    
-                    animTime = outputTime;
-                    
-                    // debug: log ping-pong transitions (only for titan, reduce spam)
-                    static float lastDebugCycleTime = -1.f;
-                    static float lastDebugOutputTime = -1.f;
-                    if (path.find("titan") != std::string::npos) {
-                        // check if we're near a transition point or if output changed significantly
-                        bool nearTransition = (cycleTime < 0.2f || cycleTime > cyclePeriod - 0.2f || 
-                                            std::abs(cycleTime - duration) < 0.2f);
-                        bool significantChange = std::abs(outputTime - lastDebugOutputTime) > 0.5f;
-                        
-                        if ((nearTransition || significantChange) && std::abs(cycleTime - lastDebugCycleTime) > 0.1f) {
-                            // std::cout << "[Animation] Ping-pong: input=" << inputTime
-                            //           << ", cycleTime=" << cycleTime
-                            //           << ", output=" << outputTime
-                            //           << ", duration=" << duration << std::endl;
-                            lastDebugCycleTime = cycleTime;
-                            lastDebugOutputTime = outputTime;
-                        }
-                    }
-                } else {
-                    // duration is 0, cannot apply ping-pong
-                    static bool pingPongWarningPrinted = false;
-                    if (!pingPongWarningPrinted && path.find("titan") != std::string::npos) {
-                        std::cout << "[Animation] WARNING: Ping-pong mode requested but duration is 0 for " << path << std::endl;
-                        pingPongWarningPrinted = true;
-                    }
+                    clipTime = cycleTime < duration ? cycleTime : cyclePeriod - cycleTime;
                 }
+                poseGlbInstance(model, shapeIndex, {animIndex, clipTime, 1.f, !pingPong}, deltaSec, ignoreRootTrans);
             }
-            
-            GLBLoader::updateAnimation(model, animTime, animIndex, ignoreRootTrans);
         } else {
-            // no animation control, use default behavior (loop first animation)
-            if (!model.animations.empty()) {
-                float duration = model.animations[0].duration;
-                float t = duration > 0.f ? std::fmod(m_glbAnimTime, duration) : m_glbAnimTime;
-                GLBLoader::updateAnimation(model, t, 0, false);
-            } else {
-                GLBLoader::updateAnimation(model, 0.0f, -1, false);
+            // no animation control, use default behavior (loop first animation; bind pose if there is none)
+            // each instance is offset along the clip so a crowd of one model does not move in lockstep
+            for (size_t n = 0; n < instances->second.size(); ++n) {
+                poseGlbInstance(model, instances->second[n], {0, m_glbAnimTime + n * kGlbInstancePhaseStep}, deltaSec,
+                                false);
             }
         }
     }
@@ -1490,10 +1685,15 @@ void Realtime::updateGlbAnimations(float deltaSec) {
 }
 
 void Realtime::deleteGlbResources() {
+    m_glbLoader.cancelAll();
+    m_glbUploads.clear();
     for (auto &[path, model] : m_glbModels) {
         GLBLoader::cleanup(model);
     }
     m_glbModels.clear();
+    for (GLBPose &pose : m_glbPoses) {
+        pose = GLBPose{};
+    }
 }
 
 // ANIMATION: reset animation timer
@@ -7,23 +7,28 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
+#include <array>
 #include <unordered_map>
 #include <QElapsedTimer>
 #include <QOpenGLWidget>
 #include <QTime>
 #include <QTimer>
 #include "settings.h"
-#include "shapes/Cube.h"
-#include "shapes/Cone.h"
-#include "shapes/Cylinder.h"
-#include "shapes/Sphere.h"
-#include "shapes/Star.h"
 #include "camera.h"
 #include "utils/sceneparser.h"
+#include "utils/geometry_cache.h"
+#include "utils/frame_profiler.h"
+#include "utils/frame_capture.h"
+#include "utils/render_graph.h"
+#include "utils/dynamic_resolution.h"
+
+class QLabel;
 
 // For monster
 #include <vector>
 #include "utils/glb_loader.h"
+#include "utils/glb_async_loader.h"
+#include "utils/bone_palette_buffer.h"
 // ANIMATION
 #include "utils/animation_director.h"
 
@@ -35,10 +40,22 @@ public:
     void sceneChanged();
     void settingsChanged();
     void saveViewportImage(std::string filePath);
+    // Write every rendered frame to <directory>/frame_NNNNN.png until stopped
+    void startRecording(const std::string &directory);
+    void stopRecording();
+    bool isRecording() const { return m_recording; }
     void setSceneFilePath(std::string path);
     // ANIMATION
     void resetAnimation();
 
+    // Headless rendering (see offlinerenderer.cpp): the caller owns a current GL context and the
+    // framebuffer the final composite is written to; time only moves through advanceTime()
+    void initializeOffscreen(GLuint targetFBO, int width, int height);
+    void advanceTime(float deltaSec);
+    void renderFrame();
+    // Block until every GLB the scene references is parsed and on the GPU
+    void finishGlbLoads();
+
 public slots:
     void tick(QTimerEvent* event);                      // Called once per tick of m_timer
 
@@ -57,8 +74,22 @@ private:
 
     // Tick Related Variables
     int m_timer;                                        // Stores timer which attempts to run ~60 times per second
+    bool m_offscreen = false;                           // driven by OfflineRenderer instead of Qt
+    GLuint m_offscreenFBO = 0;                          // composite target when m_offscreen
     QElapsedTimer m_elapsedTimer;                       // Stores timer which keeps track of actual time between frames
 
+    // Frame profiler (CPU sections + GPU timer queries) and its overlay
+    FrameProfiler m_profiler;
+    QLabel *m_profilerOverlay = nullptr;
+    QElapsedTimer m_overlayRefreshTimer;
+    void syncProfilerSettings();
+
+    // Image-sequence recording (async PBO readback + encoder threads)
+    FrameCapture m_capture;
+    bool m_recording = false;
+    std::string m_recordDirectory;
+    int m_recordFrame = 0;
+
     // Input Related Variables
     bool m_mouseDown = false;                           // Stores state of left mouse button
     glm::vec2 m_prev_mouse_pos;                         // Stores mouse position
@@ -71,44 +102,106 @@ private:
     GLuint m_vbo;
     GLuint m_shader;
     GLint m_uniViewProj;
+
+    // Uniform locations of the default shader, resolved once from the reflected table
+    struct DefaultShaderUniforms {
+        GLint model = -1;
+        GLint matAmbient = -1;
+        GLint matDiffuse = -1;
+        GLint matSpecular = -1;
+        GLint matEmissive = -1;
+        GLint matShininess = -1;
+        GLint enableStarfield = -1;
+        GLint useInstancing = -1;
+        // For monster
+        GLint useMeshTexture = -1;
+        GLint meshTexture = -1;
+        GLint useNormalMap = -1;
+        GLint normalMapTexture = -1;
+        GLint meshEmissive = -1;
+        GLint useMeshEmissiveTex = -1;
+        GLint meshEmissiveTex = -1;
+        GLint useSkinning = -1;
+        GLint boneTexture = -1;
+        GLint boneOffset = -1;
+        GLint meshPosScale = -1;
+        GLint meshPosOffset = -1;
+    };
+    DefaultShaderUniforms m_uniforms;
+    void cacheDefaultShaderUniforms();
+
+    // Per-frame scene constants, mirrored by the std140 SceneBlock in default.vert / default.frag
+    struct SceneBlock {
+        glm::mat4 view;
+        glm::mat4 proj;
+        glm::vec4 cameraPos;
+        glm::vec4 lightPos;
+        glm::vec4 lightColor;
+        float global_ka;
+        float global_kd;
+        float global_ks;
+        float timeSec;
+        float bgScrollOffset;
+        float starScrollSpeed;
+        float pad[2];
+    };
+    GLuint m_sceneUBO = 0;
     Camera m_camera;
     RenderData m_renderData;
     std::string m_sceneFilePath;
 
-    Cube m_cube;
-    Sphere m_sphere;
-    Cone m_cone;
-    Cylinder m_cylinder;
-    Star m_star;
     GLuint m_backgroundTex = 0;
+    int m_skyShape = -1;          // shape index of the sky sphere, drawn by renderSkyPass (-1: none)
+    GLuint m_skyShader = 0;
+    GLuint m_skyVAO = 0;          // empty; the fullscreen triangle comes from gl_VertexID
 
-    std::vector<GLuint> m_vaos;
-    std::vector<GLuint> m_vbos;
-    std::vector<int>    m_vboSizes;
+    // Each primitive type / tessellation is uploaded once; shapes keep a handle to their mesh
+    GeometryCache m_geometryCache;
 
     void buildVAOsFromRenderData();
 
-    // === NEW: For Bloom / offscreen rendering ===
-    GLuint m_sceneFBO = 0;
-    GLuint m_sceneColorTex = 0;
-    GLuint m_sceneDepthTex = 0;
+    // Instancing: a run of consecutive primitives of the same type and specular
+    // material shares one mesh and is drawn with a single instanced call
+    struct InstanceBatch {
+        PrimitiveType type = PrimitiveType::PRIMITIVE_CUBE;
+        size_t firstShape = 0;              // index of the first shape in m_renderData.shapes
+        size_t count = 0;                   // number of consecutive shapes in the run
+        GLuint vao = 0;
+        const CachedMesh *mesh = nullptr;   // shared mesh from m_geometryCache
+        GLuint instanceVbo = 0;             // per-instance model, emissive, diffuse, ambient
+        std::vector<float> instanceData;    // CPU copy, refreshed only for animated shapes
+    };
+    std::vector<InstanceBatch> m_instanceBatches;
+    std::vector<int> m_shapeBatch;          // shape index -> batch index (-1 if drawn on its own)
+
+    const CachedMesh *acquirePrimitiveMesh(PrimitiveType type);
+    bool isSkyShape(const RenderShapeData &shape) const;
+    void uploadInstanceBatch(InstanceBatch &batch);
+    void drawInstanceBatch(InstanceBatch &batch);
+    void deleteInstanceBatches();
 
-    GLuint m_brightFBO = 0;
-    GLuint m_brightTex = 0;
+    // === NEW: For Bloom / offscreen rendering ===
+    // Scene and post-processing passes, rebuilt every frame; owns their targets
+    RenderGraph m_renderGraph;
+    DynamicResolution m_dynamicResolution;   // scales the scene pass; the composite upscales
+    void renderScenePass();
+    void renderSkyPass();
+    void bloomDownsamplePass(GLuint source, bool prefilter);
+    void bloomUpsamplePass(GLuint source);
+    void motionBlurPass(GLuint sceneTex, GLuint depthTex, glm::vec2 motionDir, float motionAmount);
+    void compositePass(GLuint sceneTex, GLuint bloomTex, float sceneScale);
+
+    // bloom chain levels: level 0 is half resolution, each further level halves again
+    static constexpr int kBloomLevels = 6;
 
     // fullscreen quad + post-processiong shader
     GLuint m_quadVAO = 0;
     GLuint m_quadVBO = 0;
-    GLuint m_brightShader = 0;   // bright-pass
+    GLuint m_bloomDownShader = 0;   // bright-pass + 13-tap downsample
+    GLuint m_bloomUpShader = 0;     // tent upsample
+    GLuint m_motionBlurShader = 0;  // depth-aware motion blur
     GLuint m_screenShader = 0;   // draw texture on the screen
 
-    // blur
-    GLuint m_pingFBO = 0;
-    GLuint m_pingTex = 0;
-    GLuint m_pongFBO = 0;
-    GLuint m_pongTex = 0;
-    GLuint m_blurShader = 0;
-
     float m_scrollTime = 0.f;
     float m_bgScrollOffset = 0.f;
     glm::vec3 m_prevCamPos = glm::vec3(0.f);
@@ -122,14 +215,34 @@ private:
     glm::mat4 m_currViewProj = glm::mat4(1.0f);
 
     // For monster
-    std::unordered_map<std::string, GLBModel> m_glbModels;
+    std::unordered_map<std::string, GLBModel> m_glbModels;   // parsed models; drawn once model.loaded
     std::vector<std::string> m_meshFiles;
+    std::vector<GLBPose> m_glbPoses;   // per shape index, parallel to m_meshFiles; models are shared, poses are not
+    std::unordered_map<std::string, std::vector<size_t>> m_glbInstances;   // model path -> shape indices using it
     float m_glbAnimTime = 0.f;
+    GLBAsyncLoader m_glbLoader;
+    std::vector<std::string> m_glbUploads;   // parsed models still uploading, oldest first
+    BonePaletteBuffer m_bonePalettes;        // this frame's skinning palettes of all visible instances
+    std::vector<int> m_boneOffsets;          // per shape index: first palette texel this frame (-1: none)
+    std::vector<size_t> m_glbPaletteSource;  // per shape index: instance of the same model whose palette it uses
+    std::vector<int> m_sourceOffsets;        // per shape index: texel offset of its palette if it is a source
+
+    // Clip states evaluated so far for the model being updated, and the instance holding each result
+    struct GlbEvaluatedState {
+        GLBClipLayer layers[2];
+        size_t layerCount = 0;
+        size_t shapeIndex = 0;
+    };
+    std::vector<GlbEvaluatedState> m_glbEvaluated;
 
     std::string resolveMeshPath(const std::string &meshfile) const;
-    bool ensureGlbModelLoaded(const std::string &meshfile);
+    void requestGlbModel(const std::string &meshfile);
+    void pumpGlbLoads(size_t uploadBudget);
+    void uploadBonePalettes();
     void drawMeshPrimitive(size_t shapeIndex, const RenderShapeData &shape);
     void updateGlbAnimations(float deltaSec);
+    void poseGlbInstance(const GLBModel &model, size_t shapeIndex, const GLBClipLayer &clip, float deltaSec,
+                         bool ignoreRootTranslation);
     void deleteGlbResources();
 
     // ANIMATION
@@ -10,6 +10,8 @@ struct Settings {
     float nearPlane = 1;
     float farPlane = 1;
     float bloomStrength = 1.4f;
+    float exposure = 1.0f;              // scales the HDR scene + bloom before tonemapping
+    bool dynamicResolution = true;      // lower the scene pass resolution when the GPU misses 60 fps
     float bgScrollSpeed = 0.005f;
     bool perPixelFilter = false;
     bool kernelBasedFilter = false;
@@ -17,6 +19,8 @@ struct Settings {
     bool extraCredit2 = false;
     bool extraCredit3 = false;
     bool extraCredit4 = false;
+    bool showProfiler = false;          // on-screen frame timing overlay
+    std::string profilerCsvPath;        // stream frame timings here when non-empty
 };
 
 
@@ -515,6 +515,11 @@ glm::mat4 AnimationDirector::getTransform(size_t shapeIndex) const {
     return evaluatePathAnimation(shapeIndex, m_currentTime);
 }
 
+bool AnimationDirector::hasPathAnimation(size_t shapeIndex) const {
+    auto it = m_pathAnimations.find(shapeIndex);
+    return it != m_pathAnimations.end() && it->second.enabled;
+}
+
 glm::mat4 AnimationDirector::getTransform(const std::string& meshfile) const {
     auto it = m_meshfileToShapeIndex.find(meshfile);
     if (it != m_meshfileToShapeIndex.end()) {
@@ -606,6 +611,11 @@ bool AnimationDirector::isGLBAnimationPingPong(const std::string& meshfile) cons
     return control ? control->pingPong : false;
 }
 
+float AnimationDirector::getGLBAnimationSpeed(const std::string& meshfile) const {
+    const GLBAnimationControl* control = findGLBAnimationControl(meshfile);
+    return control ? control->speed : 1.0f;
+}
+
 void AnimationDirector::printAnimationInfo() const {
     std::cout << "=== Animation Director Info ===" << std::endl;
     std::cout << "Current time: " << m_currentTime << "s" << std::endl;
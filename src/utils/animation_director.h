@@ -82,6 +82,8 @@ public:
     // get transform matrix for object at current time
     glm::mat4 getTransform(size_t shapeIndex) const;
     glm::mat4 getTransform(const std::string& meshfile) const;
+    // whether the shape has an enabled path animation (otherwise getTransform returns its ctm)
+    bool hasPathAnimation(size_t shapeIndex) const;
     
     // get glb animation time for updateAnimation call
     float getGLBAnimationTime(const std::string& meshfile) const;
@@ -89,6 +91,7 @@ public:
     bool isGLBAnimationActive(const std::string& meshfile) const;
     bool shouldIgnoreRootTranslation(const std::string& meshfile) const;
     bool isGLBAnimationPingPong(const std::string& meshfile) const;
+    float getGLBAnimationSpeed(const std::string& meshfile) const;
     
     // debug interface
     void printAnimationInfo() const;
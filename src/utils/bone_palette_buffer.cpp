@@ -0,0 +1,108 @@
+#include "bone_palette_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+void BonePaletteBuffer::initializeGL() {
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    m_maxRows = static_cast<size_t>(std::max(maxTexels, 0));
+
+    for (Slot &slot : m_slots) {
+        glGenBuffers(1, &slot.buffer);
+        glGenTextures(1, &slot.texture);
+    }
+    m_current = -1;
+}
+
+void BonePaletteBuffer::cleanupGL() {
+    if (m_mapped) end();
+    for (Slot &slot : m_slots) {
+        if (slot.fence) glDeleteSync(slot.fence);
+        if (slot.texture) glDeleteTextures(1, &slot.texture);
+        if (slot.buffer) glDeleteBuffers(1, &slot.buffer);
+        slot = Slot{};
+    }
+    m_current = -1;
+}
+
+bool BonePaletteBuffer::begin(size_t rows) {
+    if (m_mapped || rows == 0 || m_slots[0].buffer == 0) return false;
+    if (rows > m_maxRows) {
+        std::cerr << "BonePaletteBuffer: " << rows << " palette rows exceed the texture buffer limit of "
+                  << m_maxRows << std::endl;
+        return false;
+    }
+
+    m_current = (m_current + 1) % kSlots;
+    Slot &slot = m_slots[m_current];
+
+    // Only waits if the GPU still reads this slot from kSlots frames ago. If the fence has not
+    // signaled by the timeout (or the wait failed), the GPU may still read the old store: orphan it
+    // below instead of writing over it unsynchronized.
+    bool orphan = false;
+    if (slot.fence) {
+        GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000000));
+        orphan = status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED;
+        if (orphan) {
+            std::cerr << "BonePaletteBuffer: GPU still busy with slot " << m_current << ", orphaning it" << std::endl;
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, slot.buffer);
+    if (slot.capacity < rows || orphan) {
+        // Grow with headroom so a few more instances don't reallocate every frame; a fresh store
+        // (same size when orphaning) leaves the old one to the GPU until it is done with it
+        slot.capacity = std::max(slot.capacity, std::min(m_maxRows, std::max(rows + rows / 2, size_t(256))));
+        glBufferData(GL_TEXTURE_BUFFER, slot.capacity * sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+        glBindTexture(GL_TEXTURE_BUFFER, slot.texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, slot.buffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+
+    void *ptr = glMapBufferRange(GL_TEXTURE_BUFFER, 0, rows * sizeof(glm::vec4),
+                                 GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    if (!ptr) {
+        std::cerr << "BonePaletteBuffer: failed to map the palette buffer" << std::endl;
+        return false;
+    }
+
+    m_mapped = static_cast<glm::vec4 *>(ptr);
+    m_rows = rows;
+    m_written = 0;
+    return true;
+}
+
+int BonePaletteBuffer::write(const glm::vec4 *rows, size_t count) {
+    if (!m_mapped || m_written + count > m_rows) return -1;
+    std::memcpy(m_mapped + m_written, rows, count * sizeof(glm::vec4));
+    const int offset = static_cast<int>(m_written);
+    m_written += count;
+    return offset;
+}
+
+void BonePaletteBuffer::end() {
+    if (!m_mapped) return;
+    glBindBuffer(GL_TEXTURE_BUFFER, m_slots[m_current].buffer);
+    glUnmapBuffer(GL_TEXTURE_BUFFER);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    m_mapped = nullptr;
+}
+
+void BonePaletteBuffer::bind(GLenum unit) const {
+    if (m_current < 0) return;
+    glActiveTexture(unit);
+    glBindTexture(GL_TEXTURE_BUFFER, m_slots[m_current].texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void BonePaletteBuffer::fence() {
+    if (m_current < 0) return;
+    Slot &slot = m_slots[m_current];
+    if (slot.fence) glDeleteSync(slot.fence);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
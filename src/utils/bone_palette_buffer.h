@@ -0,0 +1,59 @@
+#pragma once
+
+// Defined before including GLEW to suppress deprecation messages on macOS
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+#include <GL/glew.h>
+
+#include <array>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+/**
+ * Skinning palettes of every instance drawn in a frame, packed into one texture buffer
+ * (GL_RGBA32F, one texel per 3x4 palette row) that the vertex shader reads with texelFetch.
+ *
+ * Each frame writes a different buffer of a small ring. A fence after the frame's draws guards the
+ * buffer, so writing it again kSlots frames later only waits if the GPU is that far behind, and
+ * the mapping itself never synchronizes. (GL 4.1 has no persistent mapping, so each frame maps its
+ * slot unsynchronized instead of keeping it mapped.) If that wait times out or fails, the slot's
+ * store is orphaned with glBufferData and re-attached rather than written while the GPU may still
+ * read it. A slot too small for the frame is reallocated.
+ *
+ * Usage per frame: begin(totalRows), write() each instance's palette and keep the returned offset,
+ * end(), bind() before the draws, fence() after them.
+ */
+class BonePaletteBuffer {
+public:
+    static constexpr int kSlots = 3;
+
+    // Needs a current GL context
+    void initializeGL();
+    void cleanupGL();
+
+    // Map the next slot for `rows` palette rows. Returns false (and maps nothing) on failure.
+    bool begin(size_t rows);
+    // Copy `count` rows in; returns the texel offset of the first, or -1 if they don't fit
+    int write(const glm::vec4 *rows, size_t count);
+    void end();
+
+    // Bind the current slot's buffer texture to texture unit `unit`
+    void bind(GLenum unit) const;
+    void fence();
+
+private:
+    struct Slot {
+        GLuint buffer = 0;
+        GLuint texture = 0;
+        size_t capacity = 0;   // in rows
+        GLsync fence = nullptr;
+    };
+
+    std::array<Slot, kSlots> m_slots;
+    int m_current = -1;
+    glm::vec4 *m_mapped = nullptr;
+    size_t m_rows = 0;        // rows requested by begin()
+    size_t m_written = 0;
+    size_t m_maxRows = 0;     // GL_MAX_TEXTURE_BUFFER_SIZE
+};
@@ -0,0 +1,104 @@
+#include "dynamic_resolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void DynamicResolution::initializeGL() {
+    // glQueryCounter is core since 3.3
+    m_glReady = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (!m_glReady) {
+        std::cerr << "DynamicResolution: timestamp queries unavailable, scene stays at full resolution" << std::endl;
+        return;
+    }
+    for (Slot &slot : m_slots) {
+        glGenQueries(2, slot.queries);
+        slot.pending = false;
+    }
+}
+
+void DynamicResolution::cleanupGL() {
+    for (Slot &slot : m_slots) {
+        if (slot.queries[0]) glDeleteQueries(2, slot.queries);
+        slot = Slot{};
+    }
+    m_glReady = false;
+    m_inFrame = false;
+}
+
+void DynamicResolution::setEnabled(bool enabled) {
+    if (enabled == m_enabled) return;
+    m_enabled = enabled;
+
+    // Start over from full resolution rather than from a stale measurement
+    m_scale = kMaxScale;
+    ++m_generation;
+    m_haveSample = false;
+    m_framesSinceAdjust = 0;
+}
+
+void DynamicResolution::beginFrame() {
+    if (!m_glReady || !m_enabled) return;
+
+    // The slot about to be reused was submitted kFramesInFlight frames ago; pick it up if ready
+    Slot &slot = m_slots[m_current];
+    if (slot.pending) resolve(slot);
+    if (slot.pending) return;   // still in flight: skip measuring this frame
+
+    glQueryCounter(slot.queries[0], GL_TIMESTAMP);
+    slot.generation = m_generation;
+    m_inFrame = true;
+}
+
+void DynamicResolution::endFrame() {
+    if (!m_inFrame) return;
+    m_inFrame = false;
+
+    Slot &slot = m_slots[m_current];
+    glQueryCounter(slot.queries[1], GL_TIMESTAMP);
+    slot.pending = true;
+    m_current = (m_current + 1) % kFramesInFlight;
+
+    // Newer frames may already be done too; read whatever is available
+    for (Slot &other : m_slots) {
+        if (other.pending && &other != &slot) resolve(other);
+    }
+    adjust();
+}
+
+void DynamicResolution::resolve(Slot &slot) {
+    GLint available = 0;
+    glGetQueryObjectiv(slot.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return;
+
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(slot.queries[0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(slot.queries[1], GL_QUERY_RESULT, &end);
+    slot.pending = false;
+    if (slot.generation != m_generation) return;   // rendered at a scale since changed
+
+    const float ms = end > begin ? float(end - begin) * 1e-6f : 0.0f;
+    m_smoothedMs = m_haveSample ? m_smoothedMs + 0.1f * (ms - m_smoothedMs) : ms;
+    m_haveSample = true;
+}
+
+void DynamicResolution::adjust() {
+    if (!m_haveSample || ++m_framesSinceAdjust < kAdjustFrames) return;
+    m_framesSinceAdjust = 0;
+
+    // Over budget: shrink right away to the step that should fit (at least one step down);
+    // raising needs real headroom and goes one step at a time so the scale doesn't oscillate
+    float target = m_scale;
+    if (m_smoothedMs > m_budgetMs) {
+        target = std::floor(m_scale * std::sqrt(m_budgetMs / m_smoothedMs) / kScaleStep) * kScaleStep;
+    } else if (m_smoothedMs < 0.75f * m_budgetMs) {
+        target = std::round(m_scale / kScaleStep + 1.0f) * kScaleStep;
+    }
+    target = std::clamp(target, kMinScale, kMaxScale);
+    if (target == m_scale) return;
+
+    // Measure the new scale from scratch
+    m_scale = target;
+    ++m_generation;
+    m_haveSample = false;
+}
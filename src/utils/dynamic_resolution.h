@@ -0,0 +1,69 @@
+#pragma once
+
+// Defined before including GLEW to suppress deprecation messages on macOS
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+#include <GL/glew.h>
+
+#include <array>
+
+/**
+ * Frame-time driven render scale for the scene pass.
+ *
+ * beginFrame() / endFrame() bracket the frame's GPU work with GL_TIMESTAMP queries (timestamps,
+ * unlike TIME_ELAPSED, may overlap the profiler's own queries). Results are read a few frames
+ * later, once available, so measuring never stalls. A smoothed GPU time above the budget lowers the
+ * scale, one comfortably below it raises the scale again; the pixel count goes with scale squared.
+ * Changes are quantized to kScaleStep and spaced by kAdjustFrames so render targets of a new size
+ * are not reallocated every frame. A change restarts the average and drops the queries still in
+ * flight, which measured the old scale.
+ */
+class DynamicResolution {
+public:
+    static constexpr float kMinScale = 0.5f;
+    static constexpr float kMaxScale = 1.0f;
+    static constexpr float kScaleStep = 0.05f;
+
+    // Needs a current GL context; without timestamp queries the scale stays at kMaxScale
+    void initializeGL();
+    void cleanupGL();
+
+    // GPU time per frame to stay under, in milliseconds (default: 60 fps with some headroom)
+    void setBudgetMs(float ms) { m_budgetMs = ms; }
+    void setEnabled(bool enabled);
+    bool enabled() const { return m_enabled; }
+
+    void beginFrame();
+    void endFrame();
+
+    // Per-axis scale of the scene pass, in [kMinScale, kMaxScale]
+    float scale() const { return m_enabled ? m_scale : kMaxScale; }
+    float gpuMs() const { return m_smoothedMs; }
+
+private:
+    static constexpr size_t kFramesInFlight = 4;
+    static constexpr int kAdjustFrames = 15;
+
+    struct Slot {
+        GLuint queries[2] = {0, 0};   // begin / end timestamps
+        bool pending = false;
+        unsigned generation = 0;      // m_generation when issued; older results are dropped
+    };
+
+    void resolve(Slot &slot);
+    void adjust();
+
+    bool m_glReady = false;
+    bool m_enabled = true;
+    std::array<Slot, kFramesInFlight> m_slots;
+    size_t m_current = 0;
+    bool m_inFrame = false;
+
+    float m_budgetMs = 14.0f;
+    float m_smoothedMs = 0.0f;
+    bool m_haveSample = false;
+    int m_framesSinceAdjust = 0;
+    float m_scale = kMaxScale;
+    unsigned m_generation = 0;   // bumped on every scale change
+};
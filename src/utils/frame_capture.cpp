@@ -0,0 +1,190 @@
+#include "frame_capture.h"
+
+#include <QImage>
+#include <QString>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    constexpr GLuint64 kFenceTimeoutNs = 1000000000;   // 1 s per wait before warning
+}
+
+FrameCapture::FrameCapture(size_t ringSize)
+    : m_slots(std::max<size_t>(ringSize, 2))
+{
+}
+
+FrameCapture::~FrameCapture() {
+    // GL objects are released by releaseGL() while a context is current; here only the pool stops
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_jobReady.notify_all();
+    for (std::thread &worker : m_workers) {
+        worker.join();
+    }
+}
+
+void FrameCapture::capture(GLuint fbo, int width, int height, const std::string &path) {
+    Slot &slot = m_slots[m_next];
+    if (slot.busy) {
+        collect(slot, true);   // ring wrapped: this frame is ringSize frames old and almost surely done
+    }
+
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    if (!slot.pbo) glGenBuffers(1, &slot.pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    if (slot.capacity != bytes) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        slot.capacity = bytes;
+    }
+
+    GLint prevReadFbo = 0;
+    GLint prevPackAlignment = 4;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevReadFbo);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &prevPackAlignment);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);   // into the PBO, no stall
+
+    glPixelStorei(GL_PACK_ALIGNMENT, prevPackAlignment);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, prevReadFbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.width = width;
+    slot.height = height;
+    slot.path = path;
+    slot.busy = true;
+    m_next = (m_next + 1) % m_slots.size();
+
+    collectReady();
+}
+
+// Collect finished slots oldest-first without blocking; stops at the first one still in flight
+void FrameCapture::collectReady() {
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        Slot &slot = m_slots[(m_next + i) % m_slots.size()];
+        if (!slot.busy) continue;
+
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+        collect(slot, false);
+    }
+}
+
+void FrameCapture::collect(Slot &slot, bool wait) {
+    if (wait) {
+        GLenum status = GL_TIMEOUT_EXPIRED;
+        while (status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeoutNs);
+            if (status == GL_TIMEOUT_EXPIRED) {
+                std::cerr << "FrameCapture: still waiting on readback for " << slot.path << std::endl;
+            }
+        }
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    slot.busy = false;
+
+    EncodeJob job;
+    job.width = slot.width;
+    job.height = slot.height;
+    job.path = slot.path;
+
+    const size_t rowBytes = static_cast<size_t>(slot.width) * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    const auto *mapped = static_cast<const unsigned char *>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, rowBytes * slot.height, GL_MAP_READ_BIT));
+    if (mapped) {
+        // GL rows start at the bottom; flip while copying so the encoder gets a top-down image
+        job.pixels.resize(rowBytes * slot.height);
+        for (int y = 0; y < slot.height; ++y) {
+            std::memcpy(job.pixels.data() + rowBytes * y,
+                        mapped + rowBytes * (slot.height - 1 - y),
+                        rowBytes);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (!mapped) {
+        std::cerr << "FrameCapture: failed to map readback buffer for " << slot.path << std::endl;
+        ++m_failed;
+        return;
+    }
+    submit(std::move(job));
+}
+
+void FrameCapture::submit(EncodeJob job) {
+    if (m_workers.empty()) {
+        // Started on first use; leave one core for the render thread
+        unsigned int hw = std::thread::hardware_concurrency();
+        size_t workerCount = std::clamp<size_t>(hw > 1 ? hw - 1 : 1, 1, 4);
+        m_maxQueued = workerCount * 4;   // bounds memory if encoding falls behind
+        for (size_t i = 0; i < workerCount; ++i) {
+            m_workers.emplace_back(&FrameCapture::workerLoop, this);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this] { return m_jobs.size() < m_maxQueued; });
+    m_jobs.push_back(std::move(job));
+    ++m_inFlight;
+    lock.unlock();
+    m_jobReady.notify_one();
+}
+
+void FrameCapture::workerLoop() {
+    for (;;) {
+        EncodeJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobReady.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_jobs.empty()) return;   // stopping and drained
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        m_jobDone.notify_all();   // queue space freed
+
+        // RGBX: the composite pass leaves arbitrary alpha, images should be opaque
+        QImage image(job.pixels.data(), job.width, job.height, job.width * 4, QImage::Format_RGBX8888);
+        if (image.save(QString::fromStdString(job.path))) {
+            ++m_written;
+        } else {
+            std::cerr << "Failed to save image to " << job.path << std::endl;
+            ++m_failed;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_inFlight;
+        }
+        m_jobDone.notify_all();
+    }
+}
+
+void FrameCapture::waitForWorkers() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this] { return m_inFlight == 0; });
+}
+
+void FrameCapture::flush() {
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        Slot &slot = m_slots[(m_next + i) % m_slots.size()];
+        if (slot.busy) collect(slot, true);
+    }
+    waitForWorkers();
+}
+
+void FrameCapture::releaseGL() {
+    flush();
+    for (Slot &slot : m_slots) {
+        if (slot.pbo) glDeleteBuffers(1, &slot.pbo);
+        slot = Slot{};
+    }
+    m_next = 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+// Defined before including GLEW to suppress deprecation messages on macOS
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+#include <GL/glew.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Image-sequence capture that keeps the render thread off the readback and encode path.
+ *
+ * capture() issues glReadPixels into the next pixel-pack buffer of a small ring and drops a fence
+ * behind it, so the copy happens asynchronously on the GPU. A slot is only mapped once its fence has
+ * signalled (normally two frames later) or when the ring wraps around to it. The mapped rows are
+ * copied out top-down and handed to a pool of worker threads that encode the PNGs.
+ *
+ * All methods except framesWritten()/failures() need the GL context current.
+ */
+class FrameCapture {
+public:
+    explicit FrameCapture(size_t ringSize = 3);
+    ~FrameCapture();
+
+    // Queue color attachment 0 of fbo (width x height) to be written to path
+    void capture(GLuint fbo, int width, int height, const std::string &path);
+    // Read back every pending frame and wait until all of them are on disk
+    void flush();
+    // Delete the pixel-pack buffers and fences (pending frames are flushed first)
+    void releaseGL();
+
+    size_t framesWritten() const { return m_written.load(); }
+    size_t failures() const { return m_failed.load(); }
+
+private:
+    struct Slot {
+        GLuint pbo = 0;
+        size_t capacity = 0;                // bytes allocated for pbo
+        int width = 0;
+        int height = 0;
+        GLsync fence = nullptr;
+        std::string path;
+        bool busy = false;                  // readback issued, not collected yet
+    };
+
+    struct EncodeJob {
+        std::vector<unsigned char> pixels;  // RGBA, top row first
+        int width = 0;
+        int height = 0;
+        std::string path;
+    };
+
+    void collect(Slot &slot, bool wait);
+    void collectReady();
+
+    void submit(EncodeJob job);
+    void workerLoop();
+    void waitForWorkers();
+
+    std::vector<Slot> m_slots;
+    size_t m_next = 0;
+
+    // encoder pool
+    std::vector<std::thread> m_workers;
+    std::deque<EncodeJob> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_jobReady;     // workers wait for jobs / shutdown
+    std::condition_variable m_jobDone;      // producer waits for queue space / drain
+    size_t m_inFlight = 0;                  // queued + being encoded
+    size_t m_maxQueued = 0;
+    bool m_stopping = false;
+
+    std::atomic<size_t> m_written{0};
+    std::atomic<size_t> m_failed{0};
+};
@@ -0,0 +1,251 @@
+#include "frame_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+    constexpr const char *kFrameSection = "frame";
+
+    const char *kindName(FrameProfiler::Kind kind) {
+        return kind == FrameProfiler::Kind::Gpu ? "gpu" : "cpu";
+    }
+}
+
+FrameProfiler::~FrameProfiler() {
+    closeCsv();
+}
+
+void FrameProfiler::initializeGL() {
+    // GL_TIME_ELAPSED is core since 3.3; anything older just loses the GPU columns
+    m_glReady = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (!m_glReady) {
+        std::cerr << "FrameProfiler: timer queries unavailable, GPU sections disabled" << std::endl;
+    }
+}
+
+void FrameProfiler::cleanupGL() {
+    for (FrameSlot &slot : m_slots) {
+        if (!slot.queries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+        }
+        slot = FrameSlot{};
+    }
+    m_gpuActive = false;
+    m_glReady = false;
+}
+
+void FrameProfiler::setEnabled(bool enabled) {
+    if (enabled == m_enabled) return;
+    m_enabled = enabled;
+
+    // Drop half-open state so re-enabling starts from a clean frame
+    m_cpuStack.clear();
+    m_openCpuSamples.clear();
+    m_haveLastFrameEnd = false;
+}
+
+bool FrameProfiler::openCsv(const std::string &path) {
+    closeCsv();
+    m_csv.open(path, std::ios::out | std::ios::trunc);
+    if (!m_csv.is_open()) {
+        std::cerr << "FrameProfiler: failed to open " << path << " for writing" << std::endl;
+        return false;
+    }
+    m_csvPath = path;
+    m_csv << "frame,section,kind,ms\n";
+    return true;
+}
+
+void FrameProfiler::closeCsv() {
+    if (m_csv.is_open()) {
+        m_csv.close();
+    }
+    m_csvPath.clear();
+}
+
+int FrameProfiler::sectionIndex(const std::string &name, Kind kind) {
+    for (size_t i = 0; i < m_sections.size(); ++i) {
+        if (m_sections[i].kind == kind && m_sections[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    Section section;
+    section.name = name;
+    section.kind = kind;
+    m_sections.push_back(section);
+    return static_cast<int>(m_sections.size() - 1);
+}
+
+void FrameProfiler::beginCpu(const std::string &name) {
+    if (!m_enabled) return;
+    m_cpuStack.emplace_back(sectionIndex(name, Kind::Cpu), Clock::now());
+}
+
+void FrameProfiler::endCpu() {
+    if (!m_enabled || m_cpuStack.empty()) return;
+    auto [section, start] = m_cpuStack.back();
+    m_cpuStack.pop_back();
+    float ms = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    m_openCpuSamples.emplace_back(section, ms);
+}
+
+void FrameProfiler::beginGpu(const std::string &name) {
+    if (!m_enabled || !m_glReady) return;
+    if (m_gpuActive) {
+        std::cerr << "FrameProfiler: GPU section \"" << name << "\" nested, ignored" << std::endl;
+        return;
+    }
+
+    FrameSlot &slot = m_slots[m_frameIndex % kFramesInFlight];
+    if (slot.pending) {
+        // The ring wrapped before this slot's results arrived: recycle it without waiting
+        if (!tryResolve(slot)) {
+            finishFrame(slot, false);
+        }
+    }
+
+    if (slot.queriesUsed == slot.queries.size()) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        slot.queries.push_back(query);
+        slot.querySections.push_back(-1);
+    }
+    slot.querySections[slot.queriesUsed] = sectionIndex(name, Kind::Gpu);
+    glBeginQuery(GL_TIME_ELAPSED, slot.queries[slot.queriesUsed]);
+    ++slot.queriesUsed;
+    m_gpuActive = true;
+}
+
+void FrameProfiler::endGpu() {
+    if (!m_gpuActive) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    m_gpuActive = false;
+}
+
+void FrameProfiler::recordSample(int section, float ms, uint64_t frameIndex) {
+    Section &s = m_sections[section];
+    if (s.lastFrame == frameIndex && s.historyCount > 0) {
+        // Same section hit twice in one frame: accumulate into one sample
+        size_t last = (s.historyHead + kHistoryLength - 1) % kHistoryLength;
+        s.history[last] += ms;
+    } else {
+        s.history[s.historyHead] = ms;
+        s.historyHead = (s.historyHead + 1) % kHistoryLength;
+        s.historyCount = std::min(s.historyCount + 1, kHistoryLength);
+        s.lastFrame = frameIndex;
+    }
+
+    if (m_csv.is_open()) {
+        m_csv << frameIndex << ',' << s.name << ',' << kindName(s.kind) << ',' << ms << '\n';
+    }
+}
+
+// Reads a slot's GPU timings if the last query has landed; queries complete in order
+bool FrameProfiler::tryResolve(FrameSlot &slot) {
+    if (slot.queriesUsed > 0) {
+        GLuint available = 0;
+        glGetQueryObjectuiv(slot.queries[slot.queriesUsed - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+    finishFrame(slot, true);
+    return true;
+}
+
+void FrameProfiler::finishFrame(FrameSlot &slot, bool gpuResolved) {
+    for (const auto &[section, ms] : slot.cpuSamples) {
+        recordSample(section, ms, slot.frameIndex);
+    }
+    if (gpuResolved) {
+        for (size_t i = 0; i < slot.queriesUsed; ++i) {
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &ns);
+            recordSample(slot.querySections[i], static_cast<float>(ns * 1e-6), slot.frameIndex);
+        }
+    } else if (slot.queriesUsed > 0) {
+        ++m_droppedGpuFrames;
+    }
+
+    slot.pending = false;
+    slot.queriesUsed = 0;
+    slot.cpuSamples.clear();
+}
+
+void FrameProfiler::endFrame() {
+    if (!m_enabled) return;
+    if (m_gpuActive) endGpu();
+
+    Clock::time_point now = Clock::now();
+    if (m_haveLastFrameEnd) {
+        float ms = std::chrono::duration<float, std::milli>(now - m_lastFrameEnd).count();
+        m_openCpuSamples.emplace_back(sectionIndex(kFrameSection, Kind::Cpu), ms);
+    }
+    m_lastFrameEnd = now;
+    m_haveLastFrameEnd = true;
+
+    // Hand this frame's samples to its slot; queries were already issued into it
+    FrameSlot &slot = m_slots[m_frameIndex % kFramesInFlight];
+    if (slot.pending && slot.frameIndex != m_frameIndex) {
+        // No GPU section ran this frame, so the old occupant was never recycled
+        if (!tryResolve(slot)) finishFrame(slot, false);
+    }
+    slot.frameIndex = m_frameIndex;
+    slot.cpuSamples.swap(m_openCpuSamples);
+    m_openCpuSamples.clear();
+    slot.pending = true;
+    ++m_frameIndex;
+
+    // Pick up whatever finished, oldest first, without blocking
+    for (size_t i = kFramesInFlight; i > 0; --i) {
+        FrameSlot &older = m_slots[(m_frameIndex - i) % kFramesInFlight];
+        if (older.pending && !tryResolve(older)) break;
+    }
+}
+
+std::string FrameProfiler::overlayText() const {
+    std::string text;
+    char line[128];
+
+    for (Kind kind : {Kind::Cpu, Kind::Gpu}) {
+        float total = 0.f;
+        bool any = false;
+        for (const Section &s : m_sections) {
+            if (s.kind != kind || s.historyCount == 0) continue;
+            if (!any) {
+                text += kind == Kind::Cpu ? "CPU            avg ms   max ms\n"
+                                          : "GPU            avg ms   max ms\n";
+                any = true;
+            }
+            float sum = 0.f;
+            float peak = 0.f;
+            for (size_t i = 0; i < s.historyCount; ++i) {
+                sum += s.history[i];
+                peak = std::max(peak, s.history[i]);
+            }
+            float avg = sum / s.historyCount;
+            if (kind == Kind::Gpu) total += avg;
+
+            std::snprintf(line, sizeof(line), "  %-12s %7.3f  %7.3f\n", s.name.c_str(), avg, peak);
+            text += line;
+            if (s.name == kFrameSection && avg > 0.f) {
+                std::snprintf(line, sizeof(line), "  %-12s %7.1f\n", "fps", 1000.f / avg);
+                text += line;
+            }
+        }
+        if (kind == Kind::Gpu && any) {
+            std::snprintf(line, sizeof(line), "  %-12s %7.3f\n", "gpu total", total);
+            text += line;
+        }
+    }
+
+    if (m_droppedGpuFrames > 0) {
+        std::snprintf(line, sizeof(line), "(%llu frames lost GPU timings)\n",
+                      static_cast<unsigned long long>(m_droppedGpuFrames));
+        text += line;
+    }
+    if (m_csv.is_open()) {
+        text += "csv: " + m_csvPath + "\n";
+    }
+    if (!text.empty() && text.back() == '\n') text.pop_back();
+    return text;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+// Defined before including GLEW to suppress deprecation messages on macOS
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+#include <GL/glew.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Per-frame CPU/GPU section timer.
+ *
+ * CPU sections are measured with std::chrono around the marked code. GPU sections wrap their
+ * GL commands in GL_TIME_ELAPSED queries; each frame gets its own slot in a small ring of query
+ * objects and results are only read once GL reports them available, so the profiler never
+ * stalls the pipeline. GPU sections must not nest (GL allows one active TIME_ELAPSED query).
+ *
+ * Samples recorded between two endFrame() calls belong to the same frame, so CPU work done in
+ * timerEvent lands in the frame that paintGL later draws. Rolling averages feed the overlay and
+ * every resolved frame can be streamed to a CSV file (frame, section, kind, ms).
+ */
+class FrameProfiler {
+public:
+    enum class Kind { Cpu, Gpu };
+
+    // RAII helpers for sections that map cleanly onto a C++ scope
+    class CpuScope {
+    public:
+        CpuScope(FrameProfiler &profiler, const std::string &name) : m_profiler(profiler) { m_profiler.beginCpu(name); }
+        ~CpuScope() { m_profiler.endCpu(); }
+        CpuScope(const CpuScope &) = delete;
+        CpuScope &operator=(const CpuScope &) = delete;
+    private:
+        FrameProfiler &m_profiler;
+    };
+
+    class GpuScope {
+    public:
+        GpuScope(FrameProfiler &profiler, const std::string &name) : m_profiler(profiler) { m_profiler.beginGpu(name); }
+        ~GpuScope() { m_profiler.endGpu(); }
+        GpuScope(const GpuScope &) = delete;
+        GpuScope &operator=(const GpuScope &) = delete;
+    private:
+        FrameProfiler &m_profiler;
+    };
+
+    ~FrameProfiler();
+
+    // Needs a current GL context; checks for timer query support
+    void initializeGL();
+    void cleanupGL();
+
+    void setEnabled(bool enabled);
+    bool enabled() const { return m_enabled; }
+
+    // Start / stop streaming resolved frames to a CSV file. Returns false if it can't be opened.
+    bool openCsv(const std::string &path);
+    void closeCsv();
+    const std::string &csvPath() const { return m_csvPath; }
+
+    // Mark sections. CPU sections may nest; GPU sections may not.
+    void beginCpu(const std::string &name);
+    void endCpu();
+    void beginGpu(const std::string &name);
+    void endGpu();
+
+    // Close the current frame and pick up any GPU results that became available since
+    void endFrame();
+
+    // Multi-line summary of rolling averages / maxima, for the on-screen overlay
+    std::string overlayText() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kHistoryLength = 120;  // ~2 s at 60 fps
+    static constexpr size_t kFramesInFlight = 4;   // GPU query ring depth
+
+    struct Section {
+        std::string name;
+        Kind kind = Kind::Cpu;
+        std::array<float, kHistoryLength> history{};
+        size_t historyCount = 0;
+        size_t historyHead = 0;
+        uint64_t lastFrame = 0;                     // last frame that recorded a sample
+    };
+
+    struct FrameSlot {
+        uint64_t frameIndex = 0;
+        bool pending = false;                       // submitted, results not read yet
+        std::vector<GLuint> queries;                // grows to the most GPU sections seen in a frame
+        std::vector<int> querySections;
+        size_t queriesUsed = 0;
+        std::vector<std::pair<int, float>> cpuSamples;
+    };
+
+    int sectionIndex(const std::string &name, Kind kind);
+    void recordSample(int section, float ms, uint64_t frameIndex);
+    bool tryResolve(FrameSlot &slot);
+    void finishFrame(FrameSlot &slot, bool gpuResolved);
+
+    bool m_enabled = false;
+    bool m_glReady = false;
+    bool m_gpuActive = false;
+
+    std::vector<Section> m_sections;
+    std::vector<std::pair<int, Clock::time_point>> m_cpuStack;
+    std::vector<std::pair<int, float>> m_openCpuSamples;   // this frame's CPU samples so far
+
+    std::array<FrameSlot, kFramesInFlight> m_slots;
+    uint64_t m_frameIndex = 0;
+    uint64_t m_droppedGpuFrames = 0;                // frames whose queries were recycled unread
+
+    Clock::time_point m_lastFrameEnd{};
+    bool m_haveLastFrameEnd = false;
+
+    std::ofstream m_csv;
+    std::string m_csvPath;
+};
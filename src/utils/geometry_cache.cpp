@@ -0,0 +1,113 @@
+#include "geometry_cache.h"
+
+void GeometryCache::beginBuild() {
+    ++m_buildGeneration;
+}
+
+// Cube and Star only read param1, so param2 is dropped from their key to avoid duplicate meshes
+GeometryKey GeometryCache::makeKey(PrimitiveType type, int param1, int param2) {
+    GeometryKey key;
+    key.type = type;
+    key.param1 = param1;
+    key.param2 = param2;
+    if (type == PrimitiveType::PRIMITIVE_CUBE || type == PrimitiveType::PRIMITIVE_STAR) {
+        key.param2 = 0;
+    }
+    return key;
+}
+
+std::vector<float> GeometryCache::tessellate(const GeometryKey &key) {
+    switch (key.type) {
+    case PrimitiveType::PRIMITIVE_CUBE:
+        m_cube.updateParams(key.param1);
+        return m_cube.generateShape();
+    case PrimitiveType::PRIMITIVE_SPHERE:
+        m_sphere.updateParams(key.param1, key.param2);
+        return m_sphere.generateShape();
+    case PrimitiveType::PRIMITIVE_CONE:
+        m_cone.updateParams(key.param1, key.param2);
+        return m_cone.generateShape();
+    case PrimitiveType::PRIMITIVE_CYLINDER:
+        m_cylinder.updateParams(key.param1, key.param2);
+        return m_cylinder.generateShape();
+    case PrimitiveType::PRIMITIVE_STAR:
+        m_star.updateParams(key.param1, key.param2);
+        return m_star.generateShape();
+    default:
+        return {};
+    }
+}
+
+const CachedMesh *GeometryCache::acquire(PrimitiveType type, int param1, int param2) {
+    if (type == PrimitiveType::PRIMITIVE_MESH) {
+        return nullptr;   // GLB meshes are owned by GLBLoader
+    }
+
+    GeometryKey key = makeKey(type, param1, param2);
+    auto it = m_meshes.find(key);
+    if (it != m_meshes.end()) {
+        it->second.lastUsedBuild = m_buildGeneration;
+        return it->second.indexCount > 0 ? &it->second : nullptr;
+    }
+
+    CachedMesh mesh;
+    mesh.lastUsedBuild = m_buildGeneration;
+
+    std::vector<float> vertexData;
+    std::vector<uint32_t> indices;
+    Tessellator::buildIndexedMesh(tessellate(key), vertexData, indices);
+    if (!indices.empty()) {
+        glGenBuffers(1, &mesh.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+        glBufferData(GL_ARRAY_BUFFER,
+                     sizeof(float) * vertexData.size(),
+                     vertexData.data(),
+                     GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        mesh.vertexCount = static_cast<int>(vertexData.size() / 6);
+        mesh.indexCount = static_cast<int>(indices.size());
+
+        // Unbind any VAO so the element buffer binding below doesn't leak into it
+        glBindVertexArray(0);
+        glGenBuffers(1, &mesh.ebo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+        if (mesh.vertexCount <= 0xFFFF) {
+            std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+            mesh.indexType = GL_UNSIGNED_SHORT;
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                         sizeof(uint16_t) * shortIndices.size(),
+                         shortIndices.data(),
+                         GL_STATIC_DRAW);
+        } else {
+            mesh.indexType = GL_UNSIGNED_INT;
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                         sizeof(uint32_t) * indices.size(),
+                         indices.data(),
+                         GL_STATIC_DRAW);
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    auto inserted = m_meshes.emplace(key, mesh).first;
+    return inserted->second.indexCount > 0 ? &inserted->second : nullptr;
+}
+
+void GeometryCache::evictUnused() {
+    for (auto it = m_meshes.begin(); it != m_meshes.end();) {
+        if (it->second.lastUsedBuild != m_buildGeneration) {
+            if (it->second.vbo) glDeleteBuffers(1, &it->second.vbo);
+            if (it->second.ebo) glDeleteBuffers(1, &it->second.ebo);
+            it = m_meshes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void GeometryCache::clear() {
+    for (auto &[key, mesh] : m_meshes) {
+        if (mesh.vbo) glDeleteBuffers(1, &mesh.vbo);
+        if (mesh.ebo) glDeleteBuffers(1, &mesh.ebo);
+    }
+    m_meshes.clear();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// Defined before including GLEW to suppress deprecation messages on macOS
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "scenedata.h"
+#include "tessellator.h"
+#include "shapes/Cube.h"
+#include "shapes/Cone.h"
+#include "shapes/Cylinder.h"
+#include "shapes/Sphere.h"
+#include "shapes/Star.h"
+
+// Key of a tessellated primitive: its type plus the tessellation parameters it actually uses
+struct GeometryKey {
+    PrimitiveType type = PrimitiveType::PRIMITIVE_CUBE;
+    int param1 = 0;
+    int param2 = 0;
+
+    bool operator==(const GeometryKey &other) const {
+        return type == other.type && param1 == other.param1 && param2 == other.param2;
+    }
+};
+
+struct GeometryKeyHash {
+    size_t operator()(const GeometryKey &key) const {
+        size_t h = static_cast<size_t>(key.type);
+        h = h * 31 + static_cast<size_t>(key.param1);
+        h = h * 31 + static_cast<size_t>(key.param2);
+        return h;
+    }
+};
+
+// A mesh uploaded once and shared by every shape with the same key (3 pos + 3 normal per vertex),
+// stored as unique vertices plus an index buffer; bind ebo inside the VAO and draw with glDrawElements
+struct CachedMesh {
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+    int vertexCount = 0;                // unique vertices in vbo
+    int indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT; // GL_UNSIGNED_SHORT when every index fits in 16 bits
+    unsigned int lastUsedBuild = 0;     // build generation that last acquired this mesh
+};
+
+/**
+ * Tessellates and uploads each unique (primitive type, shapeParameter1, shapeParameter2)
+ * mesh exactly once. Callers hold the returned pointer as a handle and build their own VAOs
+ * around CachedMesh::vbo; handles stay valid until the mesh is evicted or the cache cleared.
+ */
+class GeometryCache {
+public:
+    // Start a new build: meshes not acquired before the next evictUnused() are released
+    void beginBuild();
+    // Return the mesh for this primitive and tessellation, creating it on first use (needs a GL context)
+    const CachedMesh *acquire(PrimitiveType type, int param1, int param2);
+    // Delete meshes that no shape acquired since beginBuild()
+    void evictUnused();
+    // Delete every cached mesh
+    void clear();
+
+    size_t size() const { return m_meshes.size(); }
+
+private:
+    static GeometryKey makeKey(PrimitiveType type, int param1, int param2);
+    std::vector<float> tessellate(const GeometryKey &key);
+
+    Cube m_cube;
+    Sphere m_sphere;
+    Cone m_cone;
+    Cylinder m_cylinder;
+    Star m_star;
+
+    std::unordered_map<GeometryKey, CachedMesh, GeometryKeyHash> m_meshes;
+    unsigned int m_buildGeneration = 0;
+};
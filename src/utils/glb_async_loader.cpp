@@ -0,0 +1,87 @@
+#include "glb_async_loader.h"
+
+#include <algorithm>
+#include <iostream>
+
+GLBAsyncLoader::~GLBAsyncLoader() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_jobReady.notify_all();
+    for (std::thread &worker : m_workers) {
+        worker.join();
+    }
+}
+
+void GLBAsyncLoader::request(const std::string &path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (std::find(m_pending.begin(), m_pending.end(), path) != m_pending.end()) return;
+
+    if (m_workers.empty()) {
+        // Started on first use; leave one core for the GUI thread
+        unsigned int hw = std::thread::hardware_concurrency();
+        size_t workerCount = std::clamp<size_t>(hw > 1 ? hw - 1 : 1, 1, 4);
+        for (size_t i = 0; i < workerCount; ++i) {
+            m_workers.emplace_back(&GLBAsyncLoader::workerLoop, this);
+        }
+    }
+
+    m_pending.push_back(path);
+    m_jobs.push_back({path, m_generation});
+    m_jobReady.notify_one();
+}
+
+std::vector<GLBAsyncLoader::Result> GLBAsyncLoader::takeFinished() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Result> finished;
+    finished.swap(m_finished);
+    return finished;
+}
+
+void GLBAsyncLoader::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this] { return m_pending.empty(); });
+}
+
+void GLBAsyncLoader::cancelAll() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Parses still running finish in the background; their results are dropped by generation
+    m_pending.clear();
+    m_jobs.clear();
+    m_finished.clear();
+    ++m_generation;
+    m_jobDone.notify_all();
+}
+
+void GLBAsyncLoader::workerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobReady.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        Result result;
+        result.path = job.path;
+        result.ok = GLBLoader::parseGLB(job.path, result.model);
+        if (!result.ok) {
+            std::cerr << "Failed to parse GLB: " << job.path << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // A cancelled parse was already removed from m_pending
+            if (job.generation == m_generation) {
+                auto it = std::find(m_pending.begin(), m_pending.end(), job.path);
+                if (it != m_pending.end()) m_pending.erase(it);
+                m_finished.push_back(std::move(result));
+            }
+        }
+        m_jobDone.notify_all();
+    }
+}
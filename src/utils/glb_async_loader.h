@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "glb_loader.h"
+
+/**
+ * Runs GLBLoader::parseGLB on a small worker pool so that file parsing, texture decoding and vertex
+ * interleaving stay off the GUI/GL thread, and several models of a scene decode concurrently.
+ *
+ * Finished models come back through takeFinished() still staged (no GL objects yet); the caller
+ * uploads them with GLBLoader::uploadGLB on the GL thread. No method touches GL.
+ */
+class GLBAsyncLoader {
+public:
+    struct Result {
+        std::string path;
+        GLBModel model;
+        bool ok = false;
+    };
+
+    GLBAsyncLoader() = default;
+    ~GLBAsyncLoader();
+
+    // Queue path for parsing; ignored if it is already queued or being parsed
+    void request(const std::string &path);
+    // Move out every model parsed since the last call
+    std::vector<Result> takeFinished();
+    // Block until every requested model has been parsed
+    void waitIdle();
+    // Drop queued requests and discard results of parses still running
+    void cancelAll();
+
+private:
+    struct Job {
+        std::string path;
+        unsigned generation = 0;
+    };
+
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<Job> m_jobs;
+    std::vector<std::string> m_pending;     // queued + being parsed
+    std::vector<Result> m_finished;
+    std::mutex m_mutex;
+    std::condition_variable m_jobReady;     // workers wait for jobs / shutdown
+    std::condition_variable m_jobDone;      // waitIdle waits for m_pending to drain
+    unsigned m_generation = 0;              // bumped by cancelAll
+    bool m_stopping = false;
+};
@@ -0,0 +1,386 @@
+#include "glb_cache.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QString>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <type_traits>
+
+namespace {
+// Bump whenever the layout below or the meaning of any staged field changes
+constexpr uint32_t kCacheVersion = 6;
+constexpr char kCacheMagic[4] = {'G', 'L', 'B', 'C'};
+
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+};
+
+// FNV-1a over the whole source file
+bool hashFile(const std::string& path, uint64_t& outHash) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    uint64_t hash = 14695981039346656037ull;
+    std::vector<char> chunk(1 << 16);
+    while (in) {
+        in.read(chunk.data(), chunk.size());
+        std::streamsize got = in.gcount();
+        for (std::streamsize i = 0; i < got; ++i) {
+            hash ^= static_cast<unsigned char>(chunk[i]);
+            hash *= 1099511628211ull;
+        }
+    }
+    outHash = hash;
+    return true;
+}
+
+bool sourceStamp(const std::string& path, uint64_t& outSize, int64_t& outMtime) {
+    std::error_code ec;
+    outSize = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    outMtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    return true;
+}
+
+class Writer {
+public:
+    explicit Writer(std::ofstream& out) : m_out(out) {}
+
+    template <typename T>
+    void pod(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        m_out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void vec(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        pod<uint64_t>(values.size());
+        m_out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    void str(const std::string& value) {
+        pod<uint64_t>(value.size());
+        m_out.write(value.data(), value.size());
+    }
+
+private:
+    std::ofstream& m_out;
+};
+
+// Bounds-checked reads from the mapping; once a read fails every later read fails too
+class Reader {
+public:
+    Reader(const unsigned char* data, size_t size) : m_cur(data), m_end(data + size) {}
+
+    bool ok() const { return m_ok; }
+
+    template <typename T>
+    void pod(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (!take(sizeof(T))) return;
+        std::memcpy(&value, m_cur - sizeof(T), sizeof(T));
+    }
+
+    template <typename T>
+    void vec(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        uint64_t count = 0;
+        pod(count);
+        if (!m_ok || count > static_cast<uint64_t>(m_end - m_cur) / sizeof(T)) {
+            m_ok = false;
+            return;
+        }
+        values.resize(count);
+        if (count > 0 && take(count * sizeof(T))) {
+            std::memcpy(values.data(), m_cur - count * sizeof(T), count * sizeof(T));
+        }
+    }
+
+    void str(std::string& value) {
+        uint64_t count = 0;
+        pod(count);
+        if (!m_ok || !take(count)) return;
+        value.assign(reinterpret_cast<const char*>(m_cur - count), count);
+    }
+
+private:
+    bool take(uint64_t bytes) {
+        if (!m_ok || bytes > static_cast<uint64_t>(m_end - m_cur)) {
+            m_ok = false;
+            return false;
+        }
+        m_cur += bytes;
+        return true;
+    }
+
+    const unsigned char* m_cur;
+    const unsigned char* m_end;
+    bool m_ok = true;
+};
+
+// One function per struct, used for both directions so the layouts cannot drift apart
+template <typename IO, typename Mesh>
+void serializeMesh(IO& io, Mesh& mesh) {
+    io.pod(mesh.indexCount);
+    io.pod(mesh.materialIndex);
+    io.pod(mesh.hasIndices);
+    io.pod(mesh.hasSkin);
+    io.pod(mesh.floatsPerVertex);
+    io.vec(mesh.stagedVertices);
+    io.vec(mesh.stagedJoints);
+    io.vec(mesh.stagedIndices);
+}
+
+template <typename IO, typename Material>
+void serializeMaterial(IO& io, Material& material) {
+    io.str(material.name);
+    io.pod(material.baseColorFactor);
+    io.pod(material.metallicFactor);
+    io.pod(material.roughnessFactor);
+    io.pod(material.emissiveFactor);
+    io.pod(material.baseColorTextureIndex);
+    io.pod(material.normalTextureIndex);
+    io.pod(material.emissiveTextureIndex);
+    io.pod(material.metallicRoughnessTextureIndex);
+    io.pod(material.ambient);
+    io.pod(material.diffuse);
+    io.pod(material.specular);
+    io.pod(material.shininess);
+    io.pod(material.hasBaseColorTexture);
+}
+
+template <typename IO, typename Texture>
+void serializeTexture(IO& io, Texture& texture) {
+    io.pod(texture.width);
+    io.pod(texture.height);
+    io.pod(texture.channels);
+    io.str(texture.path);
+    io.pod(texture.loaded);
+    io.pod(texture.contentHash);
+    io.str(texture.sourceKey);
+    io.pod(texture.format);
+}
+
+template <typename IO, typename Level>
+void serializeLevel(IO& io, Level& level) {
+    io.pod(level.width);
+    io.pod(level.height);
+    io.vec(level.data);
+}
+
+template <typename IO, typename Joint>
+void serializeJoint(IO& io, Joint& joint) {
+    io.pod(joint.nodeIndex);
+    io.str(joint.name);
+    io.pod(joint.inverseBindMatrix);
+    io.pod(joint.localTransform);
+    io.pod(joint.globalTransform);
+    io.vec(joint.children);
+    io.pod(joint.parentIndex);
+    io.pod(joint.bindTranslation);
+    io.pod(joint.bindRotation);
+    io.pod(joint.bindScale);
+}
+
+template <typename IO, typename Channel>
+void serializeChannel(IO& io, Channel& channel) {
+    io.pod(channel.nodeIndex);
+    io.pod(channel.path);
+    io.vec(channel.times);
+    io.vec(channel.translations);
+    io.vec(channel.rotations);
+    io.vec(channel.scales);
+    io.pod(channel.interpolation);
+}
+
+// Element count first, then each element through fn
+template <typename T, typename Fn>
+void writeList(Writer& out, const std::vector<T>& items, Fn fn) {
+    out.pod<uint64_t>(items.size());
+    for (const T& item : items) fn(out, item);
+}
+
+template <typename T, typename Fn>
+void readList(Reader& in, std::vector<T>& items, Fn fn) {
+    uint64_t count = 0;
+    in.pod(count);
+    // A corrupt count ends at the first read past the mapping
+    items.clear();
+    for (uint64_t i = 0; i < count && in.ok(); ++i) {
+        items.emplace_back();
+        fn(in, items.back());
+    }
+}
+
+bool readBody(Reader& in, GLBModel& model) {
+    readList(in, model.meshes, [](Reader& r, GLBMesh& m) { serializeMesh(r, m); });
+    readList(in, model.materials, [](Reader& r, GLBMaterial& m) { serializeMaterial(r, m); });
+    readList(in, model.textures, [](Reader& r, GLBTexture& t) {
+        serializeTexture(r, t);
+        readList(r, t.stagedLevels, [](Reader& rl, TextureLevel& l) { serializeLevel(rl, l); });
+    });
+
+    in.pod(model.hasSkin);
+    GLBSkin& skin = model.skin;
+    in.str(skin.name);
+    readList(in, skin.joints, [](Reader& r, GLBJoint& j) { serializeJoint(r, j); });
+    in.pod(skin.rootJointIndex);
+    in.vec(skin.jointOrder);
+    in.pod(skin.skeletonRootNodeIndex);
+    in.vec(skin.initialTransforms);
+    in.pod(skin.skeletonRootTransform);
+    in.pod(skin.skeletonRootInHierarchy);
+
+    readList(in, model.animations, [](Reader& r, GLBAnimation& a) {
+        r.str(a.name);
+        r.pod(a.duration);
+        readList(r, a.channels, [](Reader& rc, GLBAnimationChannel& c) { serializeChannel(rc, c); });
+    });
+    if (!in.ok()) return false;
+
+    // Derived lookups, cheaper to rebuild than to store
+    skin.rebuildLookups();
+    return true;
+}
+
+void writeBody(Writer& out, const GLBModel& model) {
+    writeList(out, model.meshes, [](Writer& w, const GLBMesh& m) { serializeMesh(w, m); });
+    writeList(out, model.materials, [](Writer& w, const GLBMaterial& m) { serializeMaterial(w, m); });
+    writeList(out, model.textures, [](Writer& w, const GLBTexture& t) {
+        serializeTexture(w, t);
+        writeList(w, t.stagedLevels, [](Writer& wl, const TextureLevel& l) { serializeLevel(wl, l); });
+    });
+
+    out.pod(model.hasSkin);
+    const GLBSkin& skin = model.skin;
+    out.str(skin.name);
+    writeList(out, skin.joints, [](Writer& w, const GLBJoint& j) { serializeJoint(w, j); });
+    out.pod(skin.rootJointIndex);
+    out.vec(skin.jointOrder);
+    out.pod(skin.skeletonRootNodeIndex);
+    out.vec(skin.initialTransforms);
+    out.pod(skin.skeletonRootTransform);
+    out.pod(skin.skeletonRootInHierarchy);
+
+    writeList(out, model.animations, [](Writer& w, const GLBAnimation& a) {
+        w.str(a.name);
+        w.pod(a.duration);
+        writeList(w, a.channels, [](Writer& wc, const GLBAnimationChannel& c) { serializeChannel(wc, c); });
+    });
+}
+}
+
+bool GLBCache::read(const std::string& glbPath, GLBModel& model) {
+    const std::string path = cachePath(glbPath);
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    // The mapping is released with the QFile on every return path
+    const qint64 size = file.size();
+    uchar* data = size >= static_cast<qint64>(sizeof(CacheHeader)) ? file.map(0, size) : nullptr;
+    if (!data) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version != kCacheVersion) {
+        return false;
+    }
+
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!sourceStamp(glbPath, sourceSize, sourceMtime) || sourceSize != header.sourceSize) {
+        return false;
+    }
+    bool touchHeader = false;
+    if (sourceMtime != header.sourceMtime) {
+        uint64_t hash = 0;
+        if (!hashFile(glbPath, hash) || hash != header.sourceHash) return false;
+        touchHeader = true;   // same bytes, newer timestamp: keep the cache and record the new time
+    }
+
+    Reader in(data + sizeof(header), size - sizeof(header));
+    GLBModel cached;
+    if (!readBody(in, cached)) {
+        std::cerr << "GLB cache " << path << " is truncated or corrupt, reparsing" << std::endl;
+        return false;
+    }
+    file.unmap(data);
+    file.close();
+
+    if (touchHeader) {
+        header.sourceMtime = sourceMtime;
+        std::fstream patch(path, std::ios::binary | std::ios::in | std::ios::out);
+        patch.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    cached.filepath = glbPath;
+    model = std::move(cached);
+    std::cout << "Loaded GLB from cache: " << path << std::endl;
+    return true;
+}
+
+bool GLBCache::write(const std::string& glbPath, const GLBModel& model) {
+    // A texture parsed against one already resident in TextureRegistry has no pixels of its own (unless
+    // an earlier texture of this model holds the same content); such a model cannot be cached
+    for (size_t i = 0; i < model.textures.size(); ++i) {
+        const GLBTexture& texture = model.textures[i];
+        if (!texture.loaded || !texture.stagedLevels.empty()) continue;
+        bool sharedInModel = std::any_of(model.textures.begin(), model.textures.begin() + i, [&](const GLBTexture& t) {
+            return t.contentHash == texture.contentHash && !t.stagedLevels.empty();
+        });
+        if (!sharedInModel) return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    if (!sourceStamp(glbPath, header.sourceSize, header.sourceMtime) || !hashFile(glbPath, header.sourceHash)) {
+        return false;
+    }
+
+    // Write beside the target and rename, so readers in other processes never see half a file. The
+    // temp name is unique per process and thread: parallel renders of one model each write their own
+    // and the last rename wins with a complete file
+    const std::string path = cachePath(glbPath);
+    const std::string tmpPath = path + "." + std::to_string(QCoreApplication::applicationPid()) + "-" +
+                                std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Cannot write GLB cache " << tmpPath << std::endl;
+            return false;
+        }
+        Writer writer(out);
+        writer.pod(header);
+        writeBody(writer, model);
+        if (!out) {
+            std::cerr << "Failed while writing GLB cache " << tmpPath << std::endl;
+            out.close();
+            std::filesystem::remove(tmpPath);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::cerr << "Cannot move GLB cache into place: " << ec.message() << std::endl;
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
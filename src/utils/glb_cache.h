@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include "glb_loader.h"
+
+/**
+ * On-disk cache of parsed GLB models (<model>.glb.glbcache next to the source).
+ *
+ * Holds exactly what GLBLoader::parseGLB produces: interleaved vertex / joint / index buffers,
+ * materials, encoded texture mip chains, the flattened skeleton and pre-classified animation channels,
+ * so a hit skips tinygltf, accessor conversion, PNG decoding and block compression. The file is
+ * memory-mapped and the staged buffers are filled straight from the mapping.
+ *
+ * A cache is used when its format version matches and the source file still has the recorded size
+ * and modification time. If only the time changed (e.g. after a fresh checkout), the source is
+ * hashed and a matching hash revalidates the cache. External image files a GLB references are not
+ * tracked; delete the cache after editing one. Neither method touches GL, so both can run on the
+ * GLB worker threads.
+ */
+class GLBCache {
+public:
+    // Fill model from the cache of glbPath; false if there is no valid cache
+    static bool read(const std::string& glbPath, GLBModel& model);
+
+    // Write the cache for a model freshly parsed from glbPath (staged data must still be present);
+    // refused for a model that borrowed textures already resident in TextureRegistry
+    static bool write(const std::string& glbPath, const GLBModel& model);
+
+    static std::string cachePath(const std::string& glbPath) { return glbPath + ".glbcache"; }
+};
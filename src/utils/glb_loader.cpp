@@ -1,12 +1,16 @@
 #include "glb_loader.h"
+#include "glb_cache.h"
+#include "texture_registry.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
 #include <cstring>
 #include <unordered_map>
-#include <set>
-#include <functional>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <glm/gtc/packing.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -22,20 +26,54 @@
 // Include tinygltf (it will handle including json and stb_image internally)
 #include "tiny_gltf.h"
 
+// Upload GLB meshes in the packed vertex layout (see uploadPackedVertices); false keeps 32-bit floats
+static constexpr bool kPackGlbVertices = true;
+
+// Compose skinning palettes with the SIMD kernels; false runs their scalar reference versions
+static constexpr bool kSimdSkinning = true;
+
 // Forward declarations for helper functions
+static bool parseGLBSource(const std::string& filepath, GLBModel& model);
+// In-place view of an accessor's elements inside its glTF buffer (nothing is copied)
+struct AccessorView {
+    const unsigned char* data = nullptr;   // first element
+    size_t count = 0;                      // number of elements
+    size_t stride = 0;                     // bytes between consecutive elements
+    int componentType = -1;
+    size_t numComponents = 0;
+    bool normalized = false;
+};
+
+static bool getAccessorView(const tinygltf::Model& model, int accessorIndex, AccessorView& out);
 static bool getAccessorData(const tinygltf::Model& model, int accessorIndex, std::vector<float>& outData);
-static bool getIntegerAccessorData(const tinygltf::Model& model, int accessorIndex, std::vector<unsigned int>& outData);
-static bool getIndexData(const tinygltf::Model& model, int accessorIndex, std::vector<unsigned int>& outIndices);
 static bool processMeshes(const tinygltf::Model& gltfModel, GLBModel& model);
 static bool processSkin(const tinygltf::Model& gltfModel, GLBModel& model);
 static glm::mat4 getNodeTransform(const tinygltf::Node& node);
 static bool processAnimations(const tinygltf::Model& gltfModel, GLBModel& model);
 static bool processTextures(const tinygltf::Model& gltfModel, GLBModel& model, const std::string& glbFilePath);
 static bool processMaterials(const tinygltf::Model& gltfModel, GLBModel& model);
+static void compressTextures(GLBModel& model);
 static void convertPBRToPhong(const GLBMaterial& pbrMaterial, GLBMaterial& phongMaterial);
 static std::string resolveTexturePath(const std::string& glbFilePath, const std::string& textureUri);
 
 bool GLBLoader::loadGLB(const std::string& filepath, GLBModel& model) {
+    return parseGLB(filepath, model) && uploadGLB(model);
+}
+
+bool GLBLoader::parseGLB(const std::string& filepath, GLBModel& model) {
+    if (GLBCache::read(filepath, model)) {
+        return true;
+    }
+    if (!parseGLBSource(filepath, model)) {
+        return false;
+    }
+    // Best effort: a read-only asset directory only costs the next launch a full parse
+    GLBCache::write(filepath, model);
+    return true;
+}
+
+// Full parse through tinygltf (the cache miss path of parseGLB)
+static bool parseGLBSource(const std::string& filepath, GLBModel& model) {
     tinygltf::Model gltfModel;
     tinygltf::TinyGLTF loader;
     std::string err;
@@ -124,7 +162,10 @@ bool GLBLoader::loadGLB(const std::string& filepath, GLBModel& model) {
         std::cerr << "Warning: Failed to process some materials from GLB file" << std::endl;
     }
     
-    // Process meshes and create OpenGL resources (Stage 2)
+    // Block-compress the mip chains now that materials tell which textures are normal maps
+    compressTextures(model);
+    
+    // Process meshes into staged vertex data (Stage 2)
     if (!processMeshes(gltfModel, model)) {
         std::cerr << "Failed to process meshes from GLB file" << std::endl;
         return false;
@@ -149,14 +190,11 @@ bool GLBLoader::loadGLB(const std::string& filepath, GLBModel& model) {
         }
     }
     
-    model.loaded = true;
-    
     return true;
 }
 
-// Helper function to get data from accessor
-static bool getAccessorData(const tinygltf::Model& model, int accessorIndex, 
-                           std::vector<float>& outData) {
+// Locate an accessor's elements inside its buffer, checking that every element is in range
+static bool getAccessorView(const tinygltf::Model& model, int accessorIndex, AccessorView& out) {
     if (accessorIndex < 0 || accessorIndex >= model.accessors.size()) {
         return false;
     }
@@ -173,156 +211,90 @@ static bool getAccessorData(const tinygltf::Model& model, int accessorIndex,
     
     const auto& buffer = model.buffers[bufferView.buffer];
     
-    // Calculate data offset
-    size_t byteOffset = bufferView.byteOffset + accessor.byteOffset;
-    size_t componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
-    size_t numComponents = tinygltf::GetNumComponentsInType(accessor.type);
-    size_t stride = bufferView.byteStride > 0 ? bufferView.byteStride : (componentSize * numComponents);
-    size_t count = accessor.count;
-    
-    outData.resize(count * numComponents);
-    
-    // Copy data
-    for (size_t i = 0; i < count; ++i) {
-        const unsigned char* src = buffer.data.data() + byteOffset + i * stride;
-        for (size_t j = 0; j < numComponents; ++j) {
-            float value = 0.0f;
-            switch (accessor.componentType) {
-                case TINYGLTF_COMPONENT_TYPE_FLOAT:
-                    value = *reinterpret_cast<const float*>(src + j * componentSize);
-                    break;
-                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-                    value = static_cast<float>(*reinterpret_cast<const unsigned short*>(src + j * componentSize));
-                    break;
-                case TINYGLTF_COMPONENT_TYPE_SHORT:
-                    value = static_cast<float>(*reinterpret_cast<const short*>(src + j * componentSize));
-                    break;
-                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-                    value = static_cast<float>(*reinterpret_cast<const unsigned int*>(src + j * componentSize));
-                    break;
-                case TINYGLTF_COMPONENT_TYPE_INT:
-                    value = static_cast<float>(*reinterpret_cast<const int*>(src + j * componentSize));
-                    break;
-                default:
-                    return false;
-            }
-            outData[i * numComponents + j] = value;
-        }
-    }
-    
-    return true;
-}
-
-// Helper function to get integer data from accessor (for JOINTS_0)
-static bool getIntegerAccessorData(const tinygltf::Model& model, int accessorIndex, 
-                                  std::vector<unsigned int>& outData) {
-    if (accessorIndex < 0 || accessorIndex >= model.accessors.size()) {
-        return false;
-    }
-    
-    const auto& accessor = model.accessors[accessorIndex];
-    if (accessor.bufferView < 0 || accessor.bufferView >= model.bufferViews.size()) {
+    int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+    int numComponents = tinygltf::GetNumComponentsInType(accessor.type);
+    if (componentSize <= 0 || numComponents <= 0) {
         return false;
     }
     
-    const auto& bufferView = model.bufferViews[accessor.bufferView];
-    if (bufferView.buffer < 0 || bufferView.buffer >= model.buffers.size()) {
+    size_t byteOffset = bufferView.byteOffset + accessor.byteOffset;
+    size_t elementSize = static_cast<size_t>(componentSize) * numComponents;
+    size_t stride = bufferView.byteStride > 0 ? bufferView.byteStride : elementSize;
+    if (accessor.count > 0 && byteOffset + (accessor.count - 1) * stride + elementSize > buffer.data.size()) {
+        std::cerr << "Accessor " << accessorIndex << " reads past the end of its buffer" << std::endl;
         return false;
     }
     
-    const auto& buffer = model.buffers[bufferView.buffer];
-    
-    // Calculate data offset
-    size_t byteOffset = bufferView.byteOffset + accessor.byteOffset;
-    size_t componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
-    size_t numComponents = tinygltf::GetNumComponentsInType(accessor.type);
-    size_t stride = bufferView.byteStride > 0 ? bufferView.byteStride : (componentSize * numComponents);
-    size_t count = accessor.count;
-    
-    outData.resize(count * numComponents);
-    
-    // Copy data as integers
-    for (size_t i = 0; i < count; ++i) {
-        const unsigned char* src = buffer.data.data() + byteOffset + i * stride;
-        for (size_t j = 0; j < numComponents; ++j) {
-            unsigned int value = 0;
-            switch (accessor.componentType) {
-                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-                    value = static_cast<unsigned int>(*reinterpret_cast<const unsigned char*>(src + j * componentSize));
-                    break;
-                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-                    value = static_cast<unsigned int>(*reinterpret_cast<const unsigned short*>(src + j * componentSize));
-                    break;
-                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-                    value = *reinterpret_cast<const unsigned int*>(src + j * componentSize);
-                    break;
-                case TINYGLTF_COMPONENT_TYPE_BYTE:
-                    value = static_cast<unsigned int>(*reinterpret_cast<const char*>(src + j * componentSize));
-                    break;
-                case TINYGLTF_COMPONENT_TYPE_SHORT:
-                    value = static_cast<unsigned int>(*reinterpret_cast<const short*>(src + j * componentSize));
-                    break;
-                case TINYGLTF_COMPONENT_TYPE_INT:
-                    value = static_cast<unsigned int>(*reinterpret_cast<const int*>(src + j * componentSize));
-                    break;
-                default:
-                    return false;
+    out.data = buffer.data.data() + byteOffset;
+    out.count = accessor.count;
+    out.stride = stride;
+    out.componentType = accessor.componentType;
+    out.numComponents = static_cast<size_t>(numComponents);
+    out.normalized = accessor.normalized;
+    return true;
+}
+
+// Component type Src -> Dst for every element; only the first `components` components are written,
+// dstStride values apart, so attributes can go straight into an interleaved buffer
+template <typename Src, typename Dst>
+static void unpackComponents(const AccessorView& view, size_t components, Dst* dst, size_t dstStride) {
+    // glTF normalized integers map to [0, 1] (unsigned) or [-1, 1] (signed)
+    const bool normalize = std::is_floating_point_v<Dst> && std::is_integral_v<Src> && view.normalized;
+    const float scale = normalize ? 1.0f / static_cast<float>(std::numeric_limits<Src>::max()) : 1.0f;
+    
+    const unsigned char* src = view.data;
+    for (size_t i = 0; i < view.count; ++i, src += view.stride, dst += dstStride) {
+        for (size_t c = 0; c < components; ++c) {
+            Src value;
+            std::memcpy(&value, src + c * sizeof(Src), sizeof(Src));   // strides need not be aligned
+            if (normalize) {
+                dst[c] = static_cast<Dst>(std::max(static_cast<float>(value) * scale, -1.0f));
+            } else {
+                dst[c] = static_cast<Dst>(value);
             }
-            outData[i * numComponents + j] = value;
         }
     }
-    
-    return true;
 }
 
-// Helper function to get index data
-static bool getIndexData(const tinygltf::Model& model, int accessorIndex,
-                        std::vector<unsigned int>& outIndices) {
-    if (accessorIndex < 0 || accessorIndex >= model.accessors.size()) {
-        return false;
+template <typename Dst>
+static bool unpackAccessor(const AccessorView& view, size_t components, Dst* dst, size_t dstStride) {
+    components = std::min(components, view.numComponents);
+    switch (view.componentType) {
+        case TINYGLTF_COMPONENT_TYPE_FLOAT:
+            unpackComponents<float>(view, components, dst, dstStride);
+            return true;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            unpackComponents<uint8_t>(view, components, dst, dstStride);
+            return true;
+        case TINYGLTF_COMPONENT_TYPE_BYTE:
+            unpackComponents<int8_t>(view, components, dst, dstStride);
+            return true;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            unpackComponents<uint16_t>(view, components, dst, dstStride);
+            return true;
+        case TINYGLTF_COMPONENT_TYPE_SHORT:
+            unpackComponents<int16_t>(view, components, dst, dstStride);
+            return true;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+            unpackComponents<uint32_t>(view, components, dst, dstStride);
+            return true;
+        case TINYGLTF_COMPONENT_TYPE_INT:
+            unpackComponents<int32_t>(view, components, dst, dstStride);
+            return true;
+        default:
+            return false;
     }
-    
-    const auto& accessor = model.accessors[accessorIndex];
-    if (accessor.bufferView < 0 || accessor.bufferView >= model.bufferViews.size()) {
-        return false;
-    }
-    
-    const auto& bufferView = model.bufferViews[accessor.bufferView];
-    if (bufferView.buffer < 0 || bufferView.buffer >= model.buffers.size()) {
+}
+
+// Helper function to get data from accessor (tightly packed floats)
+static bool getAccessorData(const tinygltf::Model& model, int accessorIndex, 
+                           std::vector<float>& outData) {
+    AccessorView view;
+    if (!getAccessorView(model, accessorIndex, view)) {
         return false;
     }
-    
-    const auto& buffer = model.buffers[bufferView.buffer];
-    
-    size_t byteOffset = bufferView.byteOffset + accessor.byteOffset;
-    size_t componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
-    size_t count = accessor.count;
-    
-    outIndices.resize(count);
-    
-    for (size_t i = 0; i < count; ++i) {
-        const unsigned char* src = buffer.data.data() + byteOffset + i * componentSize;
-        unsigned int index = 0;
-        switch (accessor.componentType) {
-            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-                index = static_cast<unsigned int>(*reinterpret_cast<const unsigned short*>(src));
-                break;
-            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-                index = *reinterpret_cast<const unsigned int*>(src);
-                break;
-            case TINYGLTF_COMPONENT_TYPE_SHORT:
-                index = static_cast<unsigned int>(*reinterpret_cast<const short*>(src));
-                break;
-            case TINYGLTF_COMPONENT_TYPE_INT:
-                index = static_cast<unsigned int>(*reinterpret_cast<const int*>(src));
-                break;
-            default:
-                return false;
-        }
-        outIndices[i] = index;
-    }
-    
-    return true;
+    outData.resize(view.count * view.numComponents);
+    return unpackAccessor(view, view.numComponents, outData.data(), view.numComponents);
 }
 
 // Process meshes and create OpenGL resources
@@ -340,259 +312,171 @@ static bool processMeshes(const tinygltf::Model& gltfModel, GLBModel& model) {
             mesh.materialIndex = primitive.material;
             std::cout << "  Processing primitive " << primIdx << ", materialIndex=" << mesh.materialIndex << std::endl;
             
+            // Attribute views point into the glTF buffers; nothing is unpacked until interleaving
+            auto findAttribute = [&](const char* name, AccessorView& view) {
+                auto it = primitive.attributes.find(name);
+                return it != primitive.attributes.end() && getAccessorView(gltfModel, it->second, view);
+            };
+            
             // Get vertex positions
-            std::vector<float> positions;
-            if (primitive.attributes.find("POSITION") != primitive.attributes.end()) {
-                if (!getAccessorData(gltfModel, primitive.attributes.at("POSITION"), positions)) {
-                    std::cerr << "Failed to get POSITION data" << std::endl;
-                    continue;
-                }
-            } else {
+            AccessorView positions;
+            if (primitive.attributes.find("POSITION") == primitive.attributes.end()) {
                 std::cerr << "Mesh missing POSITION attribute" << std::endl;
                 continue;
             }
-            
-            // Get normals
-            std::vector<float> normals;
-            if (primitive.attributes.find("NORMAL") != primitive.attributes.end()) {
-                if (!getAccessorData(gltfModel, primitive.attributes.at("NORMAL"), normals)) {
-                    std::cerr << "Warning: Failed to get NORMAL data, using default" << std::endl;
-                    normals.resize(positions.size());
-                    std::fill(normals.begin(), normals.end(), 0.0f);
-                }
-            } else {
-                // Generate default normals
-                normals.resize(positions.size());
-                std::fill(normals.begin(), normals.end(), 0.0f);
+            if (!findAttribute("POSITION", positions)) {
+                std::cerr << "Failed to get POSITION data" << std::endl;
+                continue;
             }
+            const size_t vertexCount = positions.count;
             
-            // Get UV coordinates (TEXCOORD_0)
-            std::vector<float> texCoords;
-            bool hasTexCoords = false;
-            if (primitive.attributes.find("TEXCOORD_0") != primitive.attributes.end()) {
-                if (getAccessorData(gltfModel, primitive.attributes.at("TEXCOORD_0"), texCoords)) {
-                    hasTexCoords = true;
-                    // Note: glTF 2.0 texture coordinates use the same convention as OpenGL
-                    // (bottom-left origin), so no flipping is needed
-                    // Debug: check UV coordinate range
-                    if (!texCoords.empty()) {
-                        float minU = texCoords[0], maxU = texCoords[0];
-                        float minV = texCoords[1], maxV = texCoords[1];
-                        for (size_t i = 0; i < texCoords.size(); i += 2) {
-                            minU = std::min(minU, texCoords[i]);
-                            maxU = std::max(maxU, texCoords[i]);
-                            minV = std::min(minV, texCoords[i+1]);
-                            maxV = std::max(maxV, texCoords[i+1]);
-                        }
-                        std::cout << "    Mesh UV range: U=[" << minU << ", " << maxU << "], V=[" << minV << ", " << maxV << "]" << std::endl;
-                    }
-                }
+            // Optional attributes must cover every vertex; otherwise the defaults below are used
+            AccessorView normals;
+            bool hasNormals = findAttribute("NORMAL", normals) && normals.count >= vertexCount;
+            AccessorView texCoords;
+            bool hasTexCoords = findAttribute("TEXCOORD_0", texCoords) && texCoords.count >= vertexCount;
+            
+            // Get skinning data (JOINTS_0 and WEIGHTS_0) if available
+            // JOINTS_0 is typically UNSIGNED_BYTE or UNSIGNED_SHORT - read as integers directly
+            // The indices in JOINTS_0 correspond to indices in the skin.joints array
+            AccessorView joints;
+            AccessorView weights;
+            bool hasSkinData = findAttribute("JOINTS_0", joints) && findAttribute("WEIGHTS_0", weights);
+            if (hasSkinData) {
+                mesh.hasSkin = true;
+                std::cout << "    Mesh has skinning data: " << joints.count << " vertices with joints" << std::endl;
             }
             
-            // If no UV coordinates, generate default ones (0,0)
-            if (!hasTexCoords) {
-                size_t vertexCount = positions.size() / 3;
-                texCoords.resize(vertexCount * 2);
-                std::fill(texCoords.begin(), texCoords.end(), 0.0f);
+            // Interleave vertex data
+            // Format: position(3) + normal(3) + texCoord(2) + weights(4) = 12 floats per vertex (if skinning)
+            // Or: position(3) + normal(3) + texCoord(2) = 8 floats if no skinning
+            // The buffer is sized once and each attribute is written into its slot of every vertex;
+            // zero-fill supplies the default normal / UV of (0, 0)
+            size_t floatsPerVertex = hasSkinData ? 12 : 8;  // Added 2 for UV coordinates
+            std::vector<float> interleavedData(vertexCount * floatsPerVertex, 0.0f);
+            float* vertices = interleavedData.data();
+            
+            if (!unpackAccessor(positions, 3, vertices, floatsPerVertex)) {
+                std::cerr << "Failed to get POSITION data" << std::endl;
+                continue;
+            }
+            if (hasNormals && !unpackAccessor(normals, 3, vertices + 3, floatsPerVertex)) {
+                std::cerr << "Warning: Failed to get NORMAL data, using default" << std::endl;
+            }
+            if (hasTexCoords && !unpackAccessor(texCoords, 2, vertices + 6, floatsPerVertex)) {
+                hasTexCoords = false;
+            }
+            if (hasTexCoords && vertexCount > 0) {
+                // Note: glTF 2.0 texture coordinates use the same convention as OpenGL
+                // (bottom-left origin), so no flipping is needed
+                // Debug: check UV coordinate range
+                float minU = vertices[6], maxU = vertices[6];
+                float minV = vertices[7], maxV = vertices[7];
+                for (size_t i = 0; i < vertexCount; ++i) {
+                    const float* uv = vertices + i * floatsPerVertex + 6;
+                    minU = std::min(minU, uv[0]);
+                    maxU = std::max(maxU, uv[0]);
+                    minV = std::min(minV, uv[1]);
+                    maxV = std::max(maxV, uv[1]);
+                }
+                std::cout << "    Mesh UV range: U=[" << minU << ", " << maxU << "], V=[" << minV << ", " << maxV << "]" << std::endl;
+            } else if (!hasTexCoords) {
                 std::cout << "    Warning: Mesh has no UV coordinates, using default (0,0)" << std::endl;
             }
             
             // Get indices
             std::vector<unsigned int> indices;
             if (primitive.indices >= 0) {
-                if (!getIndexData(gltfModel, primitive.indices, indices)) {
+                AccessorView indexView;
+                if (!getAccessorView(gltfModel, primitive.indices, indexView)) {
+                    std::cerr << "Failed to get index data" << std::endl;
+                    continue;
+                }
+                indices.resize(indexView.count);
+                if (!unpackAccessor(indexView, 1, indices.data(), 1)) {
                     std::cerr << "Failed to get index data" << std::endl;
                     continue;
                 }
                 mesh.hasIndices = true;
                 mesh.indexCount = static_cast<int>(indices.size());
             } else {
-                // No indices, generate them
-                indices.resize(positions.size() / 3);
-                for (size_t i = 0; i < indices.size(); ++i) {
-                    indices[i] = static_cast<unsigned int>(i);
-                }
+                // No indices: drawn with glDrawArrays over every vertex
                 mesh.hasIndices = false;
-                mesh.indexCount = static_cast<int>(indices.size());
-            }
-            
-            // Get skinning data (JOINTS_0 and WEIGHTS_0) if available
-            // JOINTS_0 is typically UNSIGNED_BYTE or UNSIGNED_SHORT - read as integers directly
-            // The indices in JOINTS_0 correspond to indices in the skin.joints array
-            std::vector<unsigned int> joints;
-            std::vector<float> weights;
-            bool hasSkinData = false;
-            
-            if (primitive.attributes.find("JOINTS_0") != primitive.attributes.end() &&
-                primitive.attributes.find("WEIGHTS_0") != primitive.attributes.end()) {
-                if (getIntegerAccessorData(gltfModel, primitive.attributes.at("JOINTS_0"), joints) &&
-                    getAccessorData(gltfModel, primitive.attributes.at("WEIGHTS_0"), weights)) {
-                    hasSkinData = true;
-                    mesh.hasSkin = true;
-                    std::cout << "    Mesh has skinning data: " << joints.size() / 4 << " vertices with joints" << std::endl;
-                }
+                mesh.indexCount = static_cast<int>(vertexCount);
             }
             
-            // Interleave vertex data
-            // Format: position(3) + normal(3) + texCoord(2) + weights(4) = 12 floats per vertex (if skinning)
-            // Or: position(3) + normal(3) + texCoord(2) = 8 floats if no skinning
-            size_t vertexCount = positions.size() / 3;
-            size_t floatsPerVertex = hasSkinData ? 12 : 8;  // Added 2 for UV coordinates
-            std::vector<float> interleavedData;
-            interleavedData.reserve(vertexCount * floatsPerVertex);
-            
-            // Separate integer array for bone IDs (joints)
+            // Separate integer array for bone IDs (joints); vertices past the end of JOINTS_0 keep bone 0
             std::vector<unsigned int> jointsData;
             if (hasSkinData) {
-                jointsData.reserve(vertexCount * 4);
-            }
-            
-            for (size_t i = 0; i < vertexCount; ++i) {
-                // Position
-                interleavedData.push_back(positions[i * 3 + 0]);
-                interleavedData.push_back(positions[i * 3 + 1]);
-                interleavedData.push_back(positions[i * 3 + 2]);
-                // Normal
-                interleavedData.push_back(normals[i * 3 + 0]);
-                interleavedData.push_back(normals[i * 3 + 1]);
-                interleavedData.push_back(normals[i * 3 + 2]);
-                // Texture coordinates
-                interleavedData.push_back(texCoords[i * 2 + 0]);
-                interleavedData.push_back(texCoords[i * 2 + 1]);
+                jointsData.assign(vertexCount * 4, 0u);
+                AccessorView jointRange = joints;
+                jointRange.count = std::min(joints.count, vertexCount);
+                unpackAccessor(jointRange, 4, jointsData.data(), 4);
+                // The palette holds one 3x4 entry per joint of the first skin and the shader indexes it
+                // unchecked, so keep indices inside it (bad ones would read another instance's rows)
+                const size_t skinJoints = gltfModel.skins.empty() ? 0 : gltfModel.skins[0].joints.size();
+                if (skinJoints > 0) {
+                    const unsigned int maxJoint = static_cast<unsigned int>(skinJoints - 1);
+                    for (unsigned int& joint : jointsData) joint = std::min(joint, maxJoint);
+                }
                 
-                // Joints and weights (if available)
-                if (hasSkinData) {
-                    // Joints (4 integers) - already integers
-                    // JOINTS_0 indices are relative to skin.joints array
-                    // Note: We don't clamp here because the data should be valid from glTF
-                    // Shader will clamp to [0, 199] for safety
-                    if (i * 4 + 3 < joints.size()) {
-                        // Use joints directly - they should be valid indices into the skin.joints array
-                        jointsData.push_back(joints[i * 4 + 0]);
-                        jointsData.push_back(joints[i * 4 + 1]);
-                        jointsData.push_back(joints[i * 4 + 2]);
-                        jointsData.push_back(joints[i * 4 + 3]);
+                // Weights (location 3), then normalize to ensure they sum to 1.0
+                AccessorView weightRange = weights;
+                weightRange.count = std::min(weights.count, vertexCount);
+                unpackAccessor(weightRange, 4, vertices + 8, floatsPerVertex);
+                for (size_t i = 0; i < vertexCount; ++i) {
+                    float* w = vertices + i * floatsPerVertex + 8;
+                    float totalWeight = w[0] + w[1] + w[2] + w[3];
+                    // Normalize weights if they don't sum to 1.0 (or are all zero / missing)
+                    if (totalWeight > 0.0001f) {
+                        w[0] /= totalWeight;
+                        w[1] /= totalWeight;
+                        w[2] /= totalWeight;
+                        w[3] /= totalWeight;
                     } else {
-                        jointsData.push_back(0);
-                        jointsData.push_back(0);
-                        jointsData.push_back(0);
-                        jointsData.push_back(0);
-                    }
-                    // Weights (4 floats) - normalize to ensure they sum to 1.0
-                    if (i * 4 + 3 < weights.size()) {
-                        float w0 = weights[i * 4 + 0];
-                        float w1 = weights[i * 4 + 1];
-                        float w2 = weights[i * 4 + 2];
-                        float w3 = weights[i * 4 + 3];
-                        float totalWeight = w0 + w1 + w2 + w3;
-                        // Normalize weights if they don't sum to 1.0 (or are all zero)
-                        if (totalWeight > 0.0001f) {
-                            w0 /= totalWeight;
-                            w1 /= totalWeight;
-                            w2 /= totalWeight;
-                            w3 /= totalWeight;
-                        } else {
-                            // If all weights are zero, use first bone with weight 1.0
-                            w0 = 1.0f;
-                            w1 = 0.0f;
-                            w2 = 0.0f;
-                            w3 = 0.0f;
-                        }
-                        interleavedData.push_back(w0);
-                        interleavedData.push_back(w1);
-                        interleavedData.push_back(w2);
-                        interleavedData.push_back(w3);
-                    } else {
-                        // No weights - use first bone with full weight
-                        interleavedData.push_back(1.0f);
-                        interleavedData.push_back(0.0f);
-                        interleavedData.push_back(0.0f);
-                        interleavedData.push_back(0.0f);
+                        // If all weights are zero, use first bone with weight 1.0
+                        w[0] = 1.0f;
+                        w[1] = 0.0f;
+                        w[2] = 0.0f;
+                        w[3] = 0.0f;
                     }
                 }
             }
             
-            // Create OpenGL resources
-            glGenVertexArrays(1, &mesh.vao);
-            glGenBuffers(1, &mesh.vbo);
-            if (mesh.hasIndices) {
-                glGenBuffers(1, &mesh.ebo);
-            }
-            if (hasSkinData) {
-                glGenBuffers(1, &mesh.jointsVbo);
-            }
-            
-            glBindVertexArray(mesh.vao);
-            
-            // Upload vertex data (positions, normals, weights)
-            glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-            glBufferData(GL_ARRAY_BUFFER, 
-                        interleavedData.size() * sizeof(float),
-                        interleavedData.data(),
-                        GL_STATIC_DRAW);
-            
-            // Set vertex attributes
-            size_t offset = 0;
-            // Position (location 0)
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, floatsPerVertex * sizeof(float), (void*)offset);
-            glEnableVertexAttribArray(0);
-            offset += 3 * sizeof(float);
-            
-            // Normal (location 1)
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, floatsPerVertex * sizeof(float), (void*)offset);
-            glEnableVertexAttribArray(1);
-            offset += 3 * sizeof(float);
-            
-            // Texture coordinates (location 4)
-            glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, floatsPerVertex * sizeof(float), (void*)offset);
-            glEnableVertexAttribArray(4);
-            offset += 2 * sizeof(float);
-            
-            // Joints (location 2) - CRITICAL: Use glVertexAttribIPointer for integers!
+            // Keep the vertex data for uploadGLB (GL objects are created on the GL thread)
+            mesh.floatsPerVertex = static_cast<int>(floatsPerVertex);
+            mesh.stagedVertices = std::move(interleavedData);
             if (hasSkinData) {
-                // Upload joints data as integers to separate VBO
-                glBindBuffer(GL_ARRAY_BUFFER, mesh.jointsVbo);
-                glBufferData(GL_ARRAY_BUFFER,
-                            jointsData.size() * sizeof(unsigned int),
-                            jointsData.data(),
-                            GL_STATIC_DRAW);
-                // Use glVertexAttribIPointer (with 'I') for integer attributes
-                glVertexAttribIPointer(2, 4, GL_UNSIGNED_INT, 0, (void*)0);
-                glEnableVertexAttribArray(2);
-                
-                // Weights (location 3) - back to main VBO
-                glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-                glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, floatsPerVertex * sizeof(float), (void*)offset);
-                glEnableVertexAttribArray(3);
+                mesh.stagedJoints = std::move(jointsData);
             }
-            
-            // Upload index data if present
             if (mesh.hasIndices) {
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                            indices.size() * sizeof(unsigned int),
-                            indices.data(),
-                            GL_STATIC_DRAW);
+                mesh.stagedIndices = std::move(indices);
             }
             
-            glBindVertexArray(0);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-            if (mesh.hasIndices) {
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-            }
-            
-            model.meshes.push_back(mesh);
             std::cout << "    Created mesh: materialIndex=" << mesh.materialIndex 
                       << ", hasTexCoords=" << (hasTexCoords ? "yes" : "no")
                       << ", vertexCount=" << vertexCount << std::endl;
             std::cout << "Created mesh with " << vertexCount << " vertices, " 
                       << mesh.indexCount << " indices" << std::endl;
+            model.meshes.push_back(std::move(mesh));
         }
     }
     
     return !model.meshes.empty();
 }
 
+void GLBSkin::rebuildLookups() {
+    nodeToJointMap.clear();
+    nodeToJointMap.reserve(joints.size());
+    jointParents.resize(joints.size());
+    inverseBindMatrices.resize(joints.size());
+    for (size_t i = 0; i < joints.size(); ++i) {
+        nodeToJointMap[joints[i].nodeIndex] = static_cast<int>(i);
+        jointParents[i] = joints[i].parentIndex;
+        inverseBindMatrices[i] = joints[i].inverseBindMatrix;
+    }
+}
+
 // Helper function to get node transformation matrix
 static glm::mat4 getNodeTransform(const tinygltf::Node& node) {
     glm::mat4 transform{1.0f};
@@ -679,12 +563,23 @@ static bool processSkin(const tinygltf::Model& gltfModel, GLBModel& model) {
         }
     }
     
+    // Node -> parent node in one pass over every children list (glTF nodes have at most one parent)
+    const size_t nodeCount = gltfModel.nodes.size();
+    std::vector<int> nodeParent(nodeCount, -1);
+    for (size_t n = 0; n < nodeCount; ++n) {
+        for (int childIndex : gltfModel.nodes[n].children) {
+            if (childIndex >= 0 && childIndex < static_cast<int>(nodeCount) && nodeParent[childIndex] < 0) {
+                nodeParent[childIndex] = static_cast<int>(n);
+            }
+        }
+    }
+    
     // Create joints
     model.skin.joints.clear();
     model.skin.joints.reserve(gltfSkin.joints.size());
     
-    // Build joint map for quick lookup
-    std::unordered_map<int, int> nodeIndexToJointIndex;
+    // Dense node -> joint lookup (-1 for nodes outside the skin)
+    std::vector<int> nodeToJoint(nodeCount, -1);
     
     // Store initial transforms for bind pose (needed when no animation is playing)
     std::vector<glm::mat4> initialTransforms;
@@ -725,53 +620,27 @@ static bool processSkin(const tinygltf::Model& gltfModel, GLBModel& model) {
         // Initialize global transform to local transform
         joint.globalTransform = joint.localTransform;
         
+        nodeToJoint[nodeIndex] = static_cast<int>(model.skin.joints.size());
         model.skin.joints.push_back(joint);
-        nodeIndexToJointIndex[nodeIndex] = static_cast<int>(i);
     }
     
-    // Build parent-child relationships by traversing node hierarchy
-    // Find root joint (joint that is not a child of any other joint in the skin)
-    std::set<int> childNodes;
-    for (const auto& node : gltfModel.nodes) {
-        for (int childIndex : node.children) {
-            childNodes.insert(childIndex);
+    // Build parent-child relationships: a joint's parent is its parent node, if that node is a joint
+    const int jointCount = static_cast<int>(model.skin.joints.size());
+    for (int i = 0; i < jointCount; ++i) {
+        int parentNodeIndex = nodeParent[model.skin.joints[i].nodeIndex];
+        int parentJointIndex = parentNodeIndex >= 0 ? nodeToJoint[parentNodeIndex] : -1;
+        if (parentJointIndex >= 0) {
+            model.skin.joints[i].parentIndex = parentJointIndex;
+            model.skin.joints[parentJointIndex].children.push_back(i);
         }
     }
     
-    // Find root joint (a joint whose node is not a child of any other node in the skin)
-    for (size_t i = 0; i < model.skin.joints.size(); ++i) {
-        int nodeIndex = model.skin.joints[i].nodeIndex;
-        if (childNodes.find(nodeIndex) == childNodes.end()) {
-            // This node is not a child, it might be a root
-            // But we need to check if its parent is also in the skin
-            bool isRoot = true;
-            for (const auto& node : gltfModel.nodes) {
-                for (int childIdx : node.children) {
-                    if (childIdx == nodeIndex) {
-                        // Check if parent is in skin
-                        int parentNodeIndex = -1;
-                        for (size_t j = 0; j < gltfModel.nodes.size(); ++j) {
-                            const auto& n = gltfModel.nodes[j];
-                            for (int c : n.children) {
-                                if (c == nodeIndex) {
-                                    parentNodeIndex = static_cast<int>(j);
-                                    break;
-                                }
-                            }
-                            if (parentNodeIndex >= 0) break;
-                        }
-                        if (parentNodeIndex >= 0 && nodeIndexToJointIndex.find(parentNodeIndex) != nodeIndexToJointIndex.end()) {
-                            isRoot = false;
-                        }
-                        break;
-                    }
-                }
-                if (!isRoot) break;
-            }
-            if (isRoot) {
-                model.skin.rootJointIndex = static_cast<int>(i);
-                break;
-            }
+    // Root joint: the first joint whose parent is not part of the skin
+    model.skin.rootJointIndex = -1;
+    for (int i = 0; i < jointCount; ++i) {
+        if (model.skin.joints[i].parentIndex < 0) {
+            model.skin.rootJointIndex = i;
+            break;
         }
     }
     
@@ -780,84 +649,35 @@ static bool processSkin(const tinygltf::Model& gltfModel, GLBModel& model) {
         model.skin.rootJointIndex = 0;
     }
     
-    // Build parent-child relationships
-    // First, find parents by checking which nodes have this joint's node as a child
-    for (size_t i = 0; i < model.skin.joints.size(); ++i) {
-        int nodeIndex = model.skin.joints[i].nodeIndex;
-        if (nodeIndex < 0 || nodeIndex >= gltfModel.nodes.size()) {
-            continue;
+    // Topological joint order (every parent before its children), breadth-first from all roots
+    model.skin.jointOrder.clear();
+    model.skin.jointOrder.reserve(jointCount);
+    for (int i = 0; i < jointCount; ++i) {
+        if (model.skin.joints[i].parentIndex < 0) {
+            model.skin.jointOrder.push_back(i);
         }
-        
-        // Find parent node
-        int parentNodeIndex = -1;
-        for (size_t j = 0; j < gltfModel.nodes.size(); ++j) {
-            const auto& node = gltfModel.nodes[j];
-            for (int childIdx : node.children) {
-                if (childIdx == nodeIndex) {
-                    parentNodeIndex = static_cast<int>(j);
-                    break;
-                }
-            }
-            if (parentNodeIndex >= 0) break;
-        }
-        
-        // If parent is also in the skin, establish the relationship
-        if (parentNodeIndex >= 0) {
-            auto parentIt = nodeIndexToJointIndex.find(parentNodeIndex);
-            if (parentIt != nodeIndexToJointIndex.end()) {
-                int parentJointIndex = parentIt->second;
-                // Avoid duplicate children
-                bool alreadyChild = false;
-                for (int child : model.skin.joints[parentJointIndex].children) {
-                    if (child == static_cast<int>(i)) {
-                        alreadyChild = true;
-                        break;
-                    }
-                }
-                if (!alreadyChild) {
-                    model.skin.joints[parentJointIndex].children.push_back(static_cast<int>(i));
-                }
-                model.skin.joints[i].parentIndex = parentJointIndex;
-            }
-        }
-        
-        // Also add direct children from the node's children list
-        const auto& node = gltfModel.nodes[nodeIndex];
-        for (int childNodeIndex : node.children) {
-            auto it = nodeIndexToJointIndex.find(childNodeIndex);
-            if (it != nodeIndexToJointIndex.end()) {
-                int childJointIndex = it->second;
-                // Avoid duplicate children
-                bool alreadyChild = false;
-                for (int child : model.skin.joints[i].children) {
-                    if (child == childJointIndex) {
-                        alreadyChild = true;
-                        break;
-                    }
-                }
-                if (!alreadyChild) {
-                    model.skin.joints[i].children.push_back(childJointIndex);
-                }
-                // Set parent if not already set
-                if (model.skin.joints[childJointIndex].parentIndex < 0) {
-                    model.skin.joints[childJointIndex].parentIndex = static_cast<int>(i);
-                }
-            }
+    }
+    for (size_t head = 0; head < model.skin.jointOrder.size(); ++head) {
+        for (int child : model.skin.joints[model.skin.jointOrder[head]].children) {
+            model.skin.jointOrder.push_back(child);
         }
     }
+    if (static_cast<int>(model.skin.jointOrder.size()) != jointCount) {
+        // Only possible with a parent cycle, which glTF forbids
+        std::cerr << "  Warning: skin hierarchy has a cycle, "
+                  << jointCount - model.skin.jointOrder.size() << " joints unreachable from a root" << std::endl;
+    }
     
-    // Initialize bone matrices array
-    model.skin.boneMatrices.resize(model.skin.joints.size(), glm::mat4(1.0f));
+    // Whether the skeleton root is itself a joint (then its transform is already in every global transform)
+    model.skin.skeletonRootInHierarchy = model.skin.skeletonRootNodeIndex >= 0 &&
+                                         model.skin.skeletonRootNodeIndex < static_cast<int>(nodeCount) &&
+                                         nodeToJoint[model.skin.skeletonRootNodeIndex] >= 0;
     
     // Store initial transforms for bind pose
     model.skin.initialTransforms = initialTransforms;
     
-    // Cache node to joint mapping for performance (built once at load time)
-    model.skin.nodeToJointMap.clear();
-    model.skin.nodeToJointMap.reserve(model.skin.joints.size());
-    for (size_t i = 0; i < model.skin.joints.size(); ++i) {
-        model.skin.nodeToJointMap[model.skin.joints[i].nodeIndex] = static_cast<int>(i);
-    }
+    // Cache node to joint mapping and flat joint arrays for performance (built once at load time)
+    model.skin.rebuildLookups();
     
     // Debug: print skeleton hierarchy (only first few joints to avoid spam)
     std::cout << "Skeleton structure:" << std::endl;
@@ -911,7 +731,13 @@ static bool processAnimations(const tinygltf::Model& gltfModel, GLBModel& model)
             const auto& sampler = gltfAnim.samplers[channel.sampler];
             GLBAnimationChannel animChannel;
             animChannel.nodeIndex = channel.target_node;
-            animChannel.path = channel.target_path;
+            if (channel.target_path == "translation") {
+                animChannel.path = GLBChannelPath::Translation;
+            } else if (channel.target_path == "rotation") {
+                animChannel.path = GLBChannelPath::Rotation;
+            } else if (channel.target_path == "scale") {
+                animChannel.path = GLBChannelPath::Scale;
+            }
             
             // Get interpolation type
             if (sampler.interpolation == "LINEAR") {
@@ -937,7 +763,7 @@ static bool processAnimations(const tinygltf::Model& gltfModel, GLBModel& model)
             if (sampler.output >= 0) {
                 std::vector<float> valueData;
                 if (getAccessorData(gltfModel, sampler.output, valueData)) {
-                    if (animChannel.path == "translation" || animChannel.path == "scale") {
+                    if (animChannel.path == GLBChannelPath::Translation || animChannel.path == GLBChannelPath::Scale) {
                         // Translation and scale are vec3
                         size_t keyframeCount = valueData.size() / 3;
                         animChannel.translations.reserve(keyframeCount);
@@ -945,13 +771,13 @@ static bool processAnimations(const tinygltf::Model& gltfModel, GLBModel& model)
                         
                         for (size_t i = 0; i < keyframeCount; ++i) {
                             glm::vec3 vec(valueData[i * 3 + 0], valueData[i * 3 + 1], valueData[i * 3 + 2]);
-                            if (animChannel.path == "translation") {
+                            if (animChannel.path == GLBChannelPath::Translation) {
                                 animChannel.translations.push_back(vec);
                             } else {
                                 animChannel.scales.push_back(vec);
                             }
                         }
-                    } else if (animChannel.path == "rotation") {
+                    } else if (animChannel.path == GLBChannelPath::Rotation) {
                         // Rotation is quaternion (xyzw)
                         size_t keyframeCount = valueData.size() / 4;
                         animChannel.rotations.reserve(keyframeCount);
@@ -997,208 +823,286 @@ static glm::quat slerp(const glm::quat& a, const glm::quat& b, float t) {
     return glm::slerp(a, b, t);
 }
 
-// Interpolate animation channel at given time
-static void interpolateChannel(const GLBAnimationChannel& channel, float time, 
+// Find k with times[k] <= time <= times[k + 1] (times.size() >= 2, time already clamped).
+// Playback moves forward a little each frame, so the cursor's key or the one after it is checked
+// first; seeks, loops and ping-pong reversal fall back to a binary search.
+static size_t findKeyframe(const std::vector<float>& times, float time, size_t& cursor) {
+    const size_t lastSegment = times.size() - 2;
+    if (cursor <= lastSegment) {
+        if (times[cursor] <= time && time <= times[cursor + 1]) {
+            return cursor;
+        }
+        if (cursor < lastSegment && times[cursor + 1] <= time && time <= times[cursor + 2]) {
+            return ++cursor;
+        }
+    }
+    
+    // First key strictly after time; the segment starts one before it
+    size_t upper = std::upper_bound(times.begin(), times.end(), time) - times.begin();
+    cursor = std::min(upper > 0 ? upper - 1 : 0, lastSegment);
+    return cursor;
+}
+
+// Interpolate animation channel at given time; writes only the output matching channel.path
+static void interpolateChannel(const GLBAnimationChannel& channel, float time, size_t& cursor,
                                glm::vec3& outTranslation, glm::quat& outRotation, glm::vec3& outScale) {
     if (channel.times.empty()) {
         return;
     }
     
-    // Clamp time to animation range
-    time = std::max(channel.times[0], std::min(time, channel.times.back()));
-    
-    // Find the two keyframes to interpolate between
     size_t keyframeIndex = 0;
-    for (size_t i = 0; i < channel.times.size() - 1; ++i) {
-        if (time <= channel.times[i + 1]) {
-            keyframeIndex = i;
-            break;
-        }
+    float t = 0.0f;
+    if (channel.times.size() >= 2) {
+        // Clamp time to animation range
+        time = std::max(channel.times.front(), std::min(time, channel.times.back()));
+        keyframeIndex = findKeyframe(channel.times, time, cursor);
+        
+        float t0 = channel.times[keyframeIndex];
+        float t1 = channel.times[keyframeIndex + 1];
+        t = (t1 > t0) ? (time - t0) / (t1 - t0) : 0.0f;
+        t = std::max(0.0f, std::min(1.0f, t));
     }
     
-    if (keyframeIndex >= channel.times.size() - 1) {
-        keyframeIndex = channel.times.size() - 2;
+    // Single-key channels (and short value arrays) hold the key instead of interpolating
+    switch (channel.path) {
+    case GLBChannelPath::Translation:
+        if (keyframeIndex + 1 < channel.translations.size()) {
+            outTranslation = lerp(channel.translations[keyframeIndex], 
+                                 channel.translations[keyframeIndex + 1], t);
+        } else if (keyframeIndex < channel.translations.size()) {
+            outTranslation = channel.translations[keyframeIndex];
+        }
+        break;
+    case GLBChannelPath::Rotation:
+        if (keyframeIndex + 1 < channel.rotations.size()) {
+            outRotation = slerp(channel.rotations[keyframeIndex], 
+                               channel.rotations[keyframeIndex + 1], t);
+        } else if (keyframeIndex < channel.rotations.size()) {
+            outRotation = channel.rotations[keyframeIndex];
+        }
+        break;
+    case GLBChannelPath::Scale:
+        if (keyframeIndex + 1 < channel.scales.size()) {
+            outScale = lerp(channel.scales[keyframeIndex], 
+                           channel.scales[keyframeIndex + 1], t);
+        } else if (keyframeIndex < channel.scales.size()) {
+            outScale = channel.scales[keyframeIndex];
+        }
+        break;
+    case GLBChannelPath::Unsupported:
+        break;
+    }
+}
+
+// Time within the clip: looping layers wrap, others clamp so the last key is reached exactly
+static float clipTime(const GLBAnimation& animation, const GLBClipLayer& layer) {
+    if (animation.duration <= 0.0f) {
+        return 0.0f;
+    }
+    if (!layer.loop) {
+        return std::max(0.0f, std::min(layer.time, animation.duration));
+    }
+    float time = std::fmod(layer.time, animation.duration);
+    return time < 0.0f ? time + animation.duration : time;
+}
+
+// Bind pose overwritten by one clip's channels. Channels overwrite one component each, so a joint
+// with translation + rotation channels keeps both.
+static void sampleClip(const GLBSkin& skin, const GLBAnimation& animation, float time, std::vector<size_t>& cursors,
+                       bool ignoreRootTranslation, GLBJointTRS* out) {
+    for (size_t i = 0; i < skin.joints.size(); ++i) {
+        const auto& joint = skin.joints[i];
+        out[i] = {joint.bindTranslation, joint.bindRotation, joint.bindScale};
     }
     
-    float t0 = channel.times[keyframeIndex];
-    float t1 = channel.times[keyframeIndex + 1];
-    float t = (t1 > t0) ? (time - t0) / (t1 - t0) : 0.0f;
-    t = std::max(0.0f, std::min(1.0f, t));
+    // Use cached node-to-joint map (built at load time, no per-frame overhead)
+    const auto& nodeToJoint = skin.nodeToJointMap;
     
-    // Interpolate based on path type
-    if (channel.path == "translation" && keyframeIndex < channel.translations.size() - 1) {
-        outTranslation = lerp(channel.translations[keyframeIndex], 
-                             channel.translations[keyframeIndex + 1], t);
-    } else if (channel.path == "rotation" && keyframeIndex < channel.rotations.size() - 1) {
-        outRotation = slerp(channel.rotations[keyframeIndex], 
-                           channel.rotations[keyframeIndex + 1], t);
-    } else if (channel.path == "scale" && keyframeIndex < channel.scales.size() - 1) {
-        outScale = lerp(channel.scales[keyframeIndex], 
-                       channel.scales[keyframeIndex + 1], t);
+    // Root joint keeps its bind translation when root motion is ignored
+    const int rootJoint = skin.rootJointIndex >= 0 ? skin.rootJointIndex : 0;
+    
+    // Apply animation channels - only update joints that have animation
+    for (size_t c = 0; c < animation.channels.size(); ++c) {
+        const auto& channel = animation.channels[c];
+        if (channel.path == GLBChannelPath::Unsupported) {
+            continue;
+        }
+        auto it = nodeToJoint.find(channel.nodeIndex);
+        if (it == nodeToJoint.end()) {
+            continue; // Node not in skin
+        }
+        
+        int jointIndex = it->second;
+        if (channel.path == GLBChannelPath::Translation && ignoreRootTranslation && jointIndex == rootJoint) {
+            continue;
+        }
+        GLBJointTRS& trs = out[jointIndex];
+        interpolateChannel(channel, time, cursors[c], trs.t, trs.r, trs.s);
     }
 }
 
-// Update animation and compute bone matrices
-bool GLBLoader::updateAnimation(GLBModel& model, float currentTime, int animationIndex, bool ignoreRootTranslation) {
+// Blend clips into a pose and compute bone matrices
+bool GLBLoader::evaluateClips(const GLBModel& model, GLBPose& pose, const GLBClipLayer* layers, size_t layerCount,
+                              bool ignoreRootTranslation) {
     if (!model.hasSkin || model.skin.joints.empty()) {
         return false;
     }
     
-    if (animationIndex < 0 || animationIndex >= static_cast<int>(model.animations.size())) {
-        // No animation or invalid index, use bind pose (initial transforms from nodes)
-        // Restore initial transforms
-        for (size_t i = 0; i < model.skin.joints.size() && i < model.skin.initialTransforms.size(); ++i) {
-            model.skin.joints[i].localTransform = model.skin.initialTransforms[i];
+    const auto& skin = model.skin;
+    const size_t jointCount = skin.joints.size();
+    
+    // Sized on the first call for this pose / thread; afterwards only overwritten
+    if (pose.clipCursors.size() != model.animations.size()) {
+        pose.clipCursors.resize(model.animations.size());
+        for (size_t a = 0; a < model.animations.size(); ++a) {
+            pose.clipCursors[a].assign(model.animations[a].channels.size(), 0);
         }
-        
-        // Recompute global transforms from hierarchy
-        std::function<void(int)> computeGlobalTransform = [&](int jointIndex) {
-            auto& joint = model.skin.joints[jointIndex];
-            
-            if (joint.parentIndex >= 0 && joint.parentIndex < static_cast<int>(model.skin.joints.size())) {
-                joint.globalTransform = model.skin.joints[joint.parentIndex].globalTransform * joint.localTransform;
-            } else {
-                joint.globalTransform = joint.localTransform;
-            }
-            
-            for (int childIndex : joint.children) {
-                if (childIndex >= 0 && childIndex < static_cast<int>(model.skin.joints.size())) {
-                    computeGlobalTransform(childIndex);
-                }
-            }
-        };
-        
-        if (model.skin.rootJointIndex >= 0 && model.skin.rootJointIndex < static_cast<int>(model.skin.joints.size())) {
-            computeGlobalTransform(model.skin.rootJointIndex);
-        } else if (!model.skin.joints.empty()) {
-            computeGlobalTransform(0);
+    }
+    if (pose.joints.size() != jointCount) {
+        pose.joints.resize(jointCount);
+    }
+    pose.palette.resize(jointCount * 3);
+    static thread_local std::vector<GLBJointTRS> layerJoints;
+    static thread_local std::vector<glm::mat4> locals;
+    static thread_local std::vector<glm::mat4> globals;
+    layerJoints.resize(jointCount);
+    locals.resize(jointCount);
+    globals.resize(jointCount);
+    
+    auto usable = [&](const GLBClipLayer& layer) {
+        return layer.weight > 0.0f && layer.animationIndex >= 0 &&
+               layer.animationIndex < static_cast<int>(model.animations.size());
+    };
+    float totalWeight = 0.0f;
+    for (size_t l = 0; l < layerCount; ++l) {
+        if (usable(layers[l])) totalWeight += layers[l].weight;
+    }
+    
+    JointPoseSoA& blended = pose.joints;
+    if (totalWeight <= 0.0f) {
+        // No animation, use bind pose (initial transforms from nodes)
+        for (size_t i = 0; i < jointCount; ++i) {
+            const auto& joint = skin.joints[i];
+            blended.set(i, joint.bindTranslation, joint.bindRotation, joint.bindScale);
+            locals[i] = i < skin.initialTransforms.size() ? skin.initialTransforms[i] : joint.localTransform;
         }
     } else {
-        const auto& animation = model.animations[animationIndex];
-        
-        // Loop animation time
-        float animTime = std::fmod(currentTime, animation.duration);
-        if (animTime < 0.0f) {
-            animTime += animation.duration;
-        }
-        
-        // Use cached node-to-joint map (built at load time, no per-frame overhead)
-        const auto& nodeToJoint = model.skin.nodeToJointMap;
-        
-        // Reset all joints to bind pose (use pre-decomposed TRS from load time)
-        for (auto& joint : model.skin.joints) {
-            joint.localTransform = glm::translate(glm::mat4(1.0f), joint.bindTranslation) * 
-                                  glm::mat4_cast(joint.bindRotation) * 
-                                  glm::scale(glm::mat4(1.0f), joint.bindScale);
-        }
-        
-        // Apply animation channels - only update joints that have animation
-        for (const auto& channel : animation.channels) {
-            auto it = nodeToJoint.find(channel.nodeIndex);
-            if (it == nodeToJoint.end()) {
-                continue; // Node not in skin
-            }
-            
-            int jointIndex = it->second;
-            auto& joint = model.skin.joints[jointIndex];
-            
-            // Interpolate channel values
-            glm::vec3 translation(0.0f);
-            glm::quat rotation(1.0f, 0.0f, 0.0f, 0.0f);
-            glm::vec3 scale(1.0f);
+        // Each layer is sampled into scratch and accumulated into the SoA pose. Rotations are summed
+        // on the first layer's hemisphere and normalized afterwards (nlerp).
+        bool first = true;
+        for (size_t l = 0; l < layerCount; ++l) {
+            const GLBClipLayer& layer = layers[l];
+            if (!usable(layer)) continue;
             
-            interpolateChannel(channel, animTime, translation, rotation, scale);
+            const auto& animation = model.animations[layer.animationIndex];
+            const float w = layer.weight / totalWeight;
+            sampleClip(skin, animation, clipTime(animation, layer), pose.clipCursors[layer.animationIndex],
+                       ignoreRootTranslation, layerJoints.data());
             
-            // Get current TRS from joint's bind pose
-            glm::vec3 t = joint.bindTranslation;
-            glm::quat r = joint.bindRotation;
-            glm::vec3 s = joint.bindScale;
-            
-            // Update based on channel path
-            // if ignoreRootTranslation is true and this is root joint, skip translation
-            bool isRootJoint = (jointIndex == model.skin.rootJointIndex) || 
-                              (model.skin.rootJointIndex < 0 && jointIndex == 0);
-            
-            if (channel.path == "translation") {
-                if (!ignoreRootTranslation || !isRootJoint) {
-                t = translation;
+            for (size_t i = 0; i < jointCount; ++i) {
+                const GLBJointTRS& trs = layerJoints[i];
+                if (first) {
+                    blended.set(i, trs.t * w, trs.r * w, trs.s * w);
+                    continue;
                 }
-                // else: keep bind translation for root joint
-            } else if (channel.path == "rotation") {
-                r = rotation;
-            } else if (channel.path == "scale") {
-                s = scale;
+                float sign = blended.rx[i] * trs.r.x + blended.ry[i] * trs.r.y +
+                             blended.rz[i] * trs.r.z + blended.rw[i] * trs.r.w < 0.0f ? -w : w;
+                blended.tx[i] += trs.t.x * w;
+                blended.ty[i] += trs.t.y * w;
+                blended.tz[i] += trs.t.z * w;
+                blended.rx[i] += trs.r.x * sign;
+                blended.ry[i] += trs.r.y * sign;
+                blended.rz[i] += trs.r.z * sign;
+                blended.rw[i] += trs.r.w * sign;
+                blended.sx[i] += trs.s.x * w;
+                blended.sy[i] += trs.s.y * w;
+                blended.sz[i] += trs.s.z * w;
             }
-            
-            // Rebuild local transform: T * R * S
-            joint.localTransform = glm::translate(glm::mat4(1.0f), t) * 
-                                  glm::mat4_cast(r) * 
-                                  glm::scale(glm::mat4(1.0f), s);
+            first = false;
+        }
+        for (size_t i = 0; i < jointCount; ++i) {
+            float invLength = 1.0f / std::sqrt(blended.rx[i] * blended.rx[i] + blended.ry[i] * blended.ry[i] +
+                                               blended.rz[i] * blended.rz[i] + blended.rw[i] * blended.rw[i]);
+            blended.rx[i] *= invLength;
+            blended.ry[i] *= invLength;
+            blended.rz[i] *= invLength;
+            blended.rw[i] *= invLength;
         }
         
-        // Compute global transforms recursively
-        // Global transform = parent's global transform * local transform
-        std::function<void(int)> computeGlobalTransform = [&](int jointIndex) {
-            auto& joint = model.skin.joints[jointIndex];
-            
-            if (joint.parentIndex >= 0 && joint.parentIndex < static_cast<int>(model.skin.joints.size())) {
-                // Global = parent global * local
-                joint.globalTransform = model.skin.joints[joint.parentIndex].globalTransform * joint.localTransform;
-            } else {
-                // Root joint: global = local
-                joint.globalTransform = joint.localTransform;
-            }
-            
-            // Recursively compute children
-            for (int childIndex : joint.children) {
-                if (childIndex >= 0 && childIndex < static_cast<int>(model.skin.joints.size())) {
-                    computeGlobalTransform(childIndex);
-                }
-            }
-        };
-        
-        // Start from root
-        if (model.skin.rootJointIndex >= 0 && model.skin.rootJointIndex < static_cast<int>(model.skin.joints.size())) {
-            computeGlobalTransform(model.skin.rootJointIndex);
-        } else if (!model.skin.joints.empty()) {
-            // Fallback: compute from first joint if root not found
-            computeGlobalTransform(0);
+        // One T * R * S per joint
+        if (kSimdSkinning) {
+            SkinningKernels::composeLocals(blended, locals.data());
+        } else {
+            SkinningKernels::composeLocalsScalar(blended, locals.data());
         }
     }
     
-    // Compute final bone matrices for skinning
-    // In glTF 2.0, the bone matrix transforms vertices from bind pose to current pose
-    // According to glTF spec: boneMatrix = globalTransform * inverseBindMatrix
-    // The inverseBindMatrix is relative to the skeleton root (if specified)
-    // The globalTransform already includes the skeleton root transform if skeleton root is in the hierarchy
-    // However, if skeleton root is NOT in the joint hierarchy, we need to include it separately
-    for (size_t i = 0; i < model.skin.joints.size(); ++i) {
-        const auto& globalTransform = model.skin.joints[i].globalTransform;
-        const auto& inverseBind = model.skin.joints[i].inverseBindMatrix;
-        
-        // Check if skeleton root is in the joint hierarchy
-        bool skeletonRootInHierarchy = false;
-        if (model.skin.skeletonRootNodeIndex >= 0) {
-            for (const auto& joint : model.skin.joints) {
-                if (joint.nodeIndex == model.skin.skeletonRootNodeIndex) {
-                    skeletonRootInHierarchy = true;
-                    break;
-                }
-            }
+    // Global transform = parent's global transform * local transform.
+    // jointOrder puts every parent before its children, so one linear pass covers all roots.
+    // In glTF 2.0, the bone matrix transforms vertices from bind pose to current pose:
+    // boneMatrix = globalTransform * inverseBindMatrix. The inverseBindMatrix is relative to the
+    // skeleton root (if specified); when that root is not itself a joint its transform is not in
+    // any global transform yet, so it becomes the parent of the root joints.
+    const bool applySkeletonRoot = !skin.skeletonRootInHierarchy && skin.skeletonRootNodeIndex >= 0;
+    const glm::mat4 rootTransform = applySkeletonRoot ? skin.skeletonRootTransform : glm::mat4(1.0f);
+    if (kSimdSkinning) {
+        SkinningKernels::composeGlobals(locals.data(), skin.jointParents.data(), skin.jointOrder.data(),
+                                        skin.jointOrder.size(), rootTransform, globals.data());
+        SkinningKernels::composePalette(globals.data(), skin.inverseBindMatrices.data(), jointCount,
+                                        pose.palette.data());
+    } else {
+        SkinningKernels::composeGlobalsScalar(locals.data(), skin.jointParents.data(), skin.jointOrder.data(),
+                                              skin.jointOrder.size(), rootTransform, globals.data());
+        SkinningKernels::composePaletteScalar(globals.data(), skin.inverseBindMatrices.data(), jointCount,
+                                              pose.palette.data());
+    }
+    
+    return true;
+}
+
+// Update animation and compute bone matrices
+bool GLBLoader::updateAnimation(const GLBModel& model, GLBPose& pose, const GLBClipLayer& clip, float deltaSec,
+                                bool ignoreRootTranslation) {
+    GLBClipLayer layers[2];
+    size_t layerCount = advanceClips(model, pose, clip, deltaSec, layers);
+    return evaluateClips(model, pose, layers, layerCount, ignoreRootTranslation);
+}
+
+size_t GLBLoader::advanceClips(const GLBModel& model, GLBPose& pose, const GLBClipLayer& clip, float deltaSec,
+                               GLBClipLayer outLayers[2]) {
+    const bool playable = clip.animationIndex >= 0 && clip.animationIndex < static_cast<int>(model.animations.size());
+    const int animationIndex = playable ? clip.animationIndex : -1;
+    
+    // A clip change fades the clip that was playing out; changes from or to the bind pose cut
+    if (animationIndex != pose.animationIndex) {
+        if (pose.animationIndex >= 0 && animationIndex >= 0 && pose.crossfadeSeconds > 0.0f) {
+            pose.fadeFromAnimation = pose.animationIndex;
+            pose.fadeFromTime = pose.time;
+            pose.fadeFromLoop = pose.loop;
+            pose.fadeElapsed = 0.0f;
+        } else {
+            pose.fadeFromAnimation = -1;
         }
-        
-        // Standard glTF formula: boneMatrix = globalTransform * inverseBindMatrix
-        // If skeleton root is NOT in hierarchy, we need to include its transform
-        if (!skeletonRootInHierarchy && model.skin.skeletonRootNodeIndex >= 0) {
-            // Skeleton root is outside the joint hierarchy, include its transform
-            model.skin.boneMatrices[i] = model.skin.skeletonRootTransform * globalTransform * inverseBind;
+        pose.animationIndex = animationIndex;
+    }
+    pose.time = clip.time;
+    pose.loop = clip.loop;
+    
+    outLayers[0] = {animationIndex, playable ? clip.time : 0.0f, 1.0f, clip.loop};   // the bind pose has no time
+    if (pose.fadeFromAnimation >= 0) {
+        // The outgoing clip keeps playing at normal speed while it fades
+        pose.fadeElapsed += deltaSec;
+        pose.fadeFromTime += deltaSec;
+        float fade = pose.fadeElapsed / pose.crossfadeSeconds;
+        if (fade >= 1.0f) {
+            pose.fadeFromAnimation = -1;
         } else {
-            // Standard formula (skeleton root is in hierarchy or not specified)
-            model.skin.boneMatrices[i] = globalTransform * inverseBind;
+            outLayers[0].weight = fade;
+            outLayers[1] = {pose.fadeFromAnimation, pose.fadeFromTime, 1.0f - fade, pose.fadeFromLoop};
+            return 2;
         }
     }
-    
-    return true;
+    return 1;
 }
 
 // Helper function to resolve texture path relative to GLB file
@@ -1247,11 +1151,66 @@ static std::string resolveTexturePath(const std::string& glbFilePath, const std:
     return glbDir + "/" + textureUri;
 }
 
+// Exporters may strip an image's alpha into "<name>@channels=A.<ext>" next to it; path of that file if present
+static std::string splitAlphaPath(const std::string& texturePath) {
+    if (texturePath.find("@channels=") != std::string::npos) return {};
+    size_t dot = texturePath.find_last_of('.');
+    size_t slash = texturePath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return {};
+    
+    std::string alphaPath = texturePath.substr(0, dot) + "@channels=A" + texturePath.substr(dot);
+    std::ifstream testFile(alphaPath);
+    return testFile.good() ? alphaPath : std::string();
+}
+
+// RGBA pixels from a decoded image plus the single-channel alpha file beside it
+static bool mergeSplitAlpha(const std::string& alphaPath, const unsigned char* pixels, int width, int height,
+                            int channels, std::vector<unsigned char>& outRgba) {
+    int alphaWidth = 0, alphaHeight = 0, alphaChannels = 0;
+    unsigned char* alpha = stbi_load(alphaPath.c_str(), &alphaWidth, &alphaHeight, &alphaChannels, 1);
+    if (!alpha) {
+        std::cerr << "  Failed to load split alpha: " << alphaPath << " (" << stbi_failure_reason() << ")" << std::endl;
+        return false;
+    }
+    if (alphaWidth != width || alphaHeight != height) {
+        std::cerr << "  Split alpha " << alphaPath << " is " << alphaWidth << "x" << alphaHeight
+                  << ", image is " << width << "x" << height << "; ignoring it" << std::endl;
+        stbi_image_free(alpha);
+        return false;
+    }
+    
+    const size_t texels = static_cast<size_t>(width) * height;
+    outRgba.resize(texels * 4);
+    for (size_t t = 0; t < texels; ++t) {
+        const unsigned char* src = pixels + t * channels;
+        unsigned char* dst = outRgba.data() + t * 4;
+        dst[0] = src[0];
+        dst[1] = channels >= 3 ? src[1] : src[0];
+        dst[2] = channels >= 3 ? src[2] : src[0];
+        dst[3] = alpha[t];
+    }
+    stbi_image_free(alpha);
+    return true;
+}
+
 // Process textures from GLB file
 static bool processTextures(const tinygltf::Model& gltfModel, GLBModel& model, const std::string& glbFilePath) {
     model.textures.clear();
     model.textures.reserve(gltfModel.textures.size());
     
+    // Textures only ever sampled as normal maps are encoded differently, so they get their own source key
+    std::vector<bool> normalMapOnly(gltfModel.textures.size(), false);
+    for (const auto& material : gltfModel.materials) {
+        int index = material.normalTexture.index;
+        if (index >= 0 && index < static_cast<int>(normalMapOnly.size())) normalMapOnly[index] = true;
+    }
+    for (const auto& material : gltfModel.materials) {
+        for (int index : {material.pbrMetallicRoughness.baseColorTexture.index, material.emissiveTexture.index,
+                          material.pbrMetallicRoughness.metallicRoughnessTexture.index}) {
+            if (index >= 0 && index < static_cast<int>(normalMapOnly.size())) normalMapOnly[index] = false;
+        }
+    }
+    
     for (size_t i = 0; i < gltfModel.textures.size(); ++i) {
         const auto& gltfTexture = gltfModel.textures[i];
         GLBTexture texture;
@@ -1269,6 +1228,7 @@ static bool processTextures(const tinygltf::Model& gltfModel, GLBModel& model, c
         // Get image data
         unsigned char* imageData = nullptr;
         unsigned char* externalImageData = nullptr;  // Track external data for cleanup
+        std::vector<unsigned char> mergedPixels;     // External image with its split alpha file merged in
         int width = 0, height = 0, channels = 0;
         bool isExternalTexture = false;
         
@@ -1285,6 +1245,25 @@ static bool processTextures(const tinygltf::Model& gltfModel, GLBModel& model, c
             // External image file - try to load it
             std::string texturePath = resolveTexturePath(glbFilePath, image.uri);
             std::cout << "  Texture " << i << " external file: " << image.uri << " -> " << texturePath << std::endl;
+            std::string alphaPath = splitAlphaPath(texturePath);
+            
+            // A file some other model already has resident needs neither decoding nor encoding
+            texture.sourceKey = TextureRegistry::sourceKey(texturePath, normalMapOnly[i]);
+            if (!texture.sourceKey.empty() && !alphaPath.empty()) {
+                texture.sourceKey += "+" + TextureRegistry::sourceKey(alphaPath, false);
+            }
+            TextureRegistry::Info resident;
+            if (TextureRegistry::instance().findSource(texture.sourceKey, resident)) {
+                texture.contentHash = resident.contentHash;
+                texture.format = resident.format;
+                texture.width = resident.width;
+                texture.height = resident.height;
+                texture.channels = resident.channels;
+                texture.loaded = true;
+                model.textures.push_back(std::move(texture));
+                std::cout << "  Texture " << i << " already resident, sharing it" << std::endl;
+                continue;
+            }
             
             // Use stb_image to load external texture
             externalImageData = stbi_load(texturePath.c_str(), &width, &height, &channels, 0);
@@ -1294,6 +1273,12 @@ static bool processTextures(const tinygltf::Model& gltfModel, GLBModel& model, c
                 isExternalTexture = true;
                 std::cout << "  Successfully loaded external texture: " << texturePath 
                           << " (" << width << "x" << height << ", " << channels << " channels)" << std::endl;
+                
+                if (!alphaPath.empty() && mergeSplitAlpha(alphaPath, imageData, width, height, channels, mergedPixels)) {
+                    imageData = mergedPixels.data();
+                    channels = 4;
+                    std::cout << "  Merged split alpha: " << alphaPath << std::endl;
+                }
             } else {
                 std::cerr << "  Failed to load external texture: " << texturePath 
                           << " (stb_image error: " << stbi_failure_reason() << ")" << std::endl;
@@ -1328,56 +1313,356 @@ static bool processTextures(const tinygltf::Model& gltfModel, GLBModel& model, c
             }
         }
         
-        // Create OpenGL texture
-        GLuint textureId = 0;
-        glGenTextures(1, &textureId);
-        glBindTexture(GL_TEXTURE_2D, textureId);
-        
-        // Set texture parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        
-        // Determine format and internal format
-        // Use sized internal formats for better compatibility
-        GLenum format = GL_RGB;
-        GLenum internalFormat = GL_RGB8;
-        if (channels == 1) {
-            format = GL_RED;
-            internalFormat = GL_R8;
-        } else if (channels == 2) {
-            format = GL_RG;
-            internalFormat = GL_RG8;
-        } else if (channels == 3) {
-            format = GL_RGB;
-            internalFormat = GL_RGB8;
-        } else if (channels == 4) {
-            format = GL_RGBA;
-            internalFormat = GL_RGBA8;
-        }
-        
-        // Upload texture data
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, imageData);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        
-        glBindTexture(GL_TEXTURE_2D, 0);
-        
-        texture.textureId = textureId;
+        // Keep an RGBA8 mip chain for uploadGLB (GL objects are created on the GL thread)
+        texture.stagedLevels = TextureCodec::buildMipChain(imageData, width, height, channels);
         texture.width = width;
         texture.height = height;
         texture.channels = channels;
         texture.loaded = true;
         
-        // Free external texture data after uploading to OpenGL
+        // Free external texture data once copied
         if (isExternalTexture && externalImageData) {
             stbi_image_free(externalImageData);
         }
         
-        model.textures.push_back(texture);
-        std::cout << "  Loaded texture " << i << ": " << width << "x" << height << " (" << channels << " channels), textureId=" << textureId << std::endl;
+        model.textures.push_back(std::move(texture));
+        std::cout << "  Decoded texture " << i << ": " << width << "x" << height << " (" << channels << " channels)" << std::endl;
+    }
+    
+    return true;
+}
+
+// Pick a block format per texture from its role and content, encode every mip level and keep the
+// result only if level 0 decodes back within kMaxTextureRmse (otherwise the texture stays RGBA8)
+static constexpr float kMaxTextureRmse = 12.0f;
+
+static void compressTextures(GLBModel& model) {
+    // Textures referenced only as normal maps go to BC5; any color use keeps them RGB
+    std::vector<int> normalUses(model.textures.size(), 0);
+    std::vector<int> colorUses(model.textures.size(), 0);
+    auto count = [&](std::vector<int>& uses, int index) {
+        if (index >= 0 && index < static_cast<int>(uses.size())) ++uses[index];
+    };
+    for (const auto& material : model.materials) {
+        count(normalUses, material.normalTextureIndex);
+        count(colorUses, material.baseColorTextureIndex);
+        count(colorUses, material.emissiveTextureIndex);
+        count(colorUses, material.metallicRoughnessTextureIndex);
+    }
+    
+    // Content hash -> first texture encoded with it, so repeated images are encoded once
+    std::unordered_map<uint64_t, size_t> encodedByHash;
+    
+    for (size_t i = 0; i < model.textures.size(); ++i) {
+        GLBTexture& texture = model.textures[i];
+        if (!texture.loaded || texture.stagedLevels.empty()) continue;
+        
+        const TextureLevel& base = texture.stagedLevels[0];
+        bool grey = true, opaque = true;
+        for (size_t p = 0; p < base.data.size(); p += 4) {
+            grey = grey && base.data[p] == base.data[p + 1] && base.data[p] == base.data[p + 2];
+            opaque = opaque && base.data[p + 3] == 255;
+        }
+        
+        TextureFormat format = TextureFormat::BC1;
+        if (normalUses[i] > 0 && colorUses[i] == 0) {
+            format = TextureFormat::BC5;
+        } else if (!opaque) {
+            format = TextureFormat::BC3;
+        } else if (grey) {
+            format = TextureFormat::BC4;
+        }
+        
+        uint64_t hash = TextureRegistry::contentHash(base, format);
+        auto seen = encodedByHash.find(hash);
+        if (seen != encodedByHash.end()) {
+            const GLBTexture& first = model.textures[seen->second];
+            texture.format = first.format;
+            texture.contentHash = first.contentHash;
+            std::vector<TextureLevel>().swap(texture.stagedLevels);   // uploadGLB shares the first one's texture
+            continue;
+        }
+        encodedByHash[hash] = i;
+        
+        std::vector<TextureLevel> encoded;
+        encoded.reserve(texture.stagedLevels.size());
+        for (const auto& level : texture.stagedLevels) {
+            encoded.push_back(TextureCodec::encode(format, level));
+        }
+        
+        float error = TextureCodec::rmse(format, base, TextureCodec::decode(format, encoded[0]));
+        if (error > kMaxTextureRmse) {
+            std::cout << "  Texture " << i << " kept as RGBA8 (block error " << error << ")" << std::endl;
+            texture.contentHash = TextureRegistry::contentHash(base, TextureFormat::RGBA8);
+            continue;
+        }
+        texture.format = format;
+        texture.contentHash = hash;
+        texture.stagedLevels = std::move(encoded);
+    }
+}
+
+// Float layout: the staged interleaved floats as-is plus a separate 4 x uint joints VBO
+static size_t uploadFloatVertices(GLBMesh& mesh) {
+    const size_t floatsPerVertex = mesh.floatsPerVertex;
+    const bool hasSkinData = !mesh.stagedJoints.empty();
+    
+    glGenBuffers(1, &mesh.vbo);
+    if (hasSkinData) {
+        glGenBuffers(1, &mesh.jointsVbo);
+    }
+    
+    // Upload vertex data (positions, normals, weights)
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, 
+                mesh.stagedVertices.size() * sizeof(float),
+                mesh.stagedVertices.data(),
+                GL_STATIC_DRAW);
+    
+    // Set vertex attributes
+    size_t offset = 0;
+    // Position (location 0)
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, floatsPerVertex * sizeof(float), (void*)offset);
+    glEnableVertexAttribArray(0);
+    offset += 3 * sizeof(float);
+    
+    // Normal (location 1)
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, floatsPerVertex * sizeof(float), (void*)offset);
+    glEnableVertexAttribArray(1);
+    offset += 3 * sizeof(float);
+    
+    // Texture coordinates (location 4)
+    glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, floatsPerVertex * sizeof(float), (void*)offset);
+    glEnableVertexAttribArray(4);
+    offset += 2 * sizeof(float);
+    
+    // Joints (location 2) - CRITICAL: Use glVertexAttribIPointer for integers!
+    if (hasSkinData) {
+        // Upload joints data as integers to separate VBO
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.jointsVbo);
+        glBufferData(GL_ARRAY_BUFFER,
+                    mesh.stagedJoints.size() * sizeof(unsigned int),
+                    mesh.stagedJoints.data(),
+                    GL_STATIC_DRAW);
+        // Use glVertexAttribIPointer (with 'I') for integer attributes
+        glVertexAttribIPointer(2, 4, GL_UNSIGNED_INT, 0, (void*)0);
+        glEnableVertexAttribArray(2);
+        
+        // Weights (location 3) - back to main VBO
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, floatsPerVertex * sizeof(float), (void*)offset);
+        glEnableVertexAttribArray(3);
     }
     
+    return mesh.stagedVertices.size() * sizeof(float) + mesh.stagedJoints.size() * sizeof(unsigned int);
+}
+
+// Signed-normalized 10:10:10:2 (GL_INT_2_10_10_10_REV), x in the low bits
+static uint32_t packNormal1010102(const glm::vec3& n) {
+    auto snorm10 = [](float v) {
+        int q = static_cast<int>(std::round(std::clamp(v, -1.0f, 1.0f) * 511.0f));
+        return static_cast<uint32_t>(q) & 0x3FFu;
+    };
+    return snorm10(n.x) | (snorm10(n.y) << 10) | (snorm10(n.z) << 20);
+}
+
+// Packed layout, one interleaved VBO (24 bytes skinned, 16 static; the float layout needs 64 / 32):
+//   position  4 x uint16 unorm inside the mesh bounds (w unused), decoded with posOffset / posScale
+//   normal    GL_INT_2_10_10_10_REV snorm
+//   uv        2 x half float (glTF UVs may tile outside [0, 1])
+//   weights   4 x uint8 unorm, rounded so they still sum to 255         (skinned only)
+//   joints    4 x uint8, or 4 x uint16 when an index exceeds 255        (skinned only)
+static size_t uploadPackedVertices(GLBMesh& mesh) {
+    const size_t floatsPerVertex = mesh.floatsPerVertex;
+    const bool hasSkinData = !mesh.stagedJoints.empty();
+    const size_t vertexCount = floatsPerVertex > 0 ? mesh.stagedVertices.size() / floatsPerVertex : 0;
+    const float* src = mesh.stagedVertices.data();
+    
+    glm::vec3 minPos(0.0f);
+    glm::vec3 maxPos(0.0f);
+    if (vertexCount > 0) {
+        minPos = maxPos = glm::vec3(src[0], src[1], src[2]);
+    }
+    for (size_t i = 1; i < vertexCount; ++i) {
+        glm::vec3 p(src[i * floatsPerVertex + 0], src[i * floatsPerVertex + 1], src[i * floatsPerVertex + 2]);
+        minPos = glm::min(minPos, p);
+        maxPos = glm::max(maxPos, p);
+    }
+    glm::vec3 extent = maxPos - minPos;
+    for (int c = 0; c < 3; ++c) {
+        if (extent[c] <= 0.0f) extent[c] = 1.0f;   // flat axis: any scale decodes to minPos
+    }
+    mesh.posOffset = minPos;
+    mesh.posScale = extent;
+    
+    unsigned int maxJoint = 0;
+    for (unsigned int joint : mesh.stagedJoints) {
+        maxJoint = std::max(maxJoint, joint);
+    }
+    const bool wideJoints = maxJoint > 255;
+    const size_t stride = 16 + (hasSkinData ? 4 + (wideJoints ? 8 : 4) : 0);
+    
+    std::vector<unsigned char> packed(vertexCount * stride);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const float* v = src + i * floatsPerVertex;
+        unsigned char* dst = packed.data() + i * stride;
+        
+        uint16_t position[4] = {0, 0, 0, 0};
+        for (int c = 0; c < 3; ++c) {
+            float t = (v[c] - minPos[c]) / extent[c];
+            position[c] = static_cast<uint16_t>(std::round(std::clamp(t, 0.0f, 1.0f) * 65535.0f));
+        }
+        std::memcpy(dst, position, 8);
+        
+        uint32_t normal = packNormal1010102(glm::vec3(v[3], v[4], v[5]));
+        std::memcpy(dst + 8, &normal, 4);
+        
+        uint16_t uv[2] = {glm::packHalf1x16(v[6]), glm::packHalf1x16(v[7])};
+        std::memcpy(dst + 12, uv, 4);
+        
+        if (hasSkinData) {
+            // Round each weight, then give the rounding error to the largest so the sum stays exact
+            uint8_t weights[4];
+            int sum = 0;
+            int largest = 0;
+            for (int c = 0; c < 4; ++c) {
+                weights[c] = static_cast<uint8_t>(std::round(std::clamp(v[8 + c], 0.0f, 1.0f) * 255.0f));
+                sum += weights[c];
+                if (v[8 + c] > v[8 + largest]) largest = c;
+            }
+            weights[largest] = static_cast<uint8_t>(std::clamp(weights[largest] + 255 - sum, 0, 255));
+            std::memcpy(dst + 16, weights, 4);
+            
+            const unsigned int* joints = mesh.stagedJoints.data() + i * 4;
+            if (wideJoints) {
+                uint16_t ids[4];
+                for (int c = 0; c < 4; ++c) ids[c] = static_cast<uint16_t>(std::min(joints[c], 65535u));
+                std::memcpy(dst + 20, ids, 8);
+            } else {
+                uint8_t ids[4];
+                for (int c = 0; c < 4; ++c) ids[c] = static_cast<uint8_t>(joints[c]);
+                std::memcpy(dst + 20, ids, 4);
+            }
+        }
+    }
+    
+    glGenBuffers(1, &mesh.vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+    
+    glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)8);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(4, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)12);
+    glEnableVertexAttribArray(4);
+    if (hasSkinData) {
+        glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)16);
+        glEnableVertexAttribArray(3);
+        glVertexAttribIPointer(2, 4, wideJoints ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE, stride, (void*)20);
+        glEnableVertexAttribArray(2);
+    }
+    
+    mesh.packed = true;
+    return packed.size();
+}
+
+// Create the GL objects for one staged mesh and release its CPU copy
+static size_t uploadMesh(GLBMesh& mesh) {
+    glGenVertexArrays(1, &mesh.vao);
+    glBindVertexArray(mesh.vao);
+    
+    size_t bytes = kPackGlbVertices ? uploadPackedVertices(mesh) : uploadFloatVertices(mesh);
+    
+    // Upload index data if present
+    if (mesh.hasIndices) {
+        glGenBuffers(1, &mesh.ebo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                    mesh.stagedIndices.size() * sizeof(unsigned int),
+                    mesh.stagedIndices.data(),
+                    GL_STATIC_DRAW);
+        bytes += mesh.stagedIndices.size() * sizeof(unsigned int);
+    }
+    
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (mesh.hasIndices) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    
+    std::vector<float>().swap(mesh.stagedVertices);
+    std::vector<unsigned int>().swap(mesh.stagedJoints);
+    std::vector<unsigned int>().swap(mesh.stagedIndices);
+    return bytes;
+}
+
+// Create the GL texture for one staged mip chain and release its CPU copy
+static size_t uploadTexture(GLBTexture& texture) {
+    GLuint textureId = 0;
+    glGenTextures(1, &textureId);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    
+    // Set texture parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    TextureCodec::applyFiltering();
+    
+    // Every level was built (and block-compressed) at parse time, so no glGenerateMipmap here
+    TextureCodec::upload(texture.format, texture.stagedLevels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    texture.textureId = textureId;
+    size_t bytes = 0;
+    for (const auto& level : texture.stagedLevels) bytes += level.data.size();
+    std::vector<TextureLevel>().swap(texture.stagedLevels);
+    return bytes;
+}
+
+bool GLBLoader::uploadGLB(GLBModel& model, size_t byteBudget) {
+    // Items still staged are the ones without GL objects; each call continues where the last stopped.
+    // The budget is only checked once something was uploaded, so even a budget of 0 makes progress.
+    size_t uploaded = 0;
+    bool uploadedAny = false;
+    TextureRegistry& registry = TextureRegistry::instance();
+    for (size_t textureIndex = 0; textureIndex < model.textures.size(); ++textureIndex) {
+        GLBTexture& texture = model.textures[textureIndex];
+        if (!texture.loaded || texture.textureId != 0) continue;
+        if (uploadedAny && uploaded >= byteBudget) return false;
+        
+        // Same content already on the GPU (from this model or another one): take a reference
+        texture.textureId = registry.acquire(texture.contentHash);
+        if (texture.textureId != 0) {
+            std::vector<TextureLevel>().swap(texture.stagedLevels);
+            continue;
+        }
+        if (texture.stagedLevels.empty()) {
+            // Parsed against a resident texture that has been released since
+            std::cerr << "  Texture " << texture.path << " is no longer resident; reload the model" << std::endl;
+            texture.loaded = false;
+            // Materials using it fall back to their factors
+            const int index = static_cast<int>(textureIndex);
+            for (auto& material : model.materials) {
+                if (material.baseColorTextureIndex == index) material.hasBaseColorTexture = false;
+                if (material.normalTextureIndex == index) material.normalTextureIndex = -1;
+                if (material.emissiveTextureIndex == index) material.emissiveTextureIndex = -1;
+            }
+            continue;
+        }
+        
+        TextureRegistry::Info info{texture.contentHash, texture.format, texture.width, texture.height, texture.channels};
+        uploaded += uploadTexture(texture);
+        uploadedAny = true;
+        registry.insert(texture.textureId, texture.sourceKey, info);
+    }
+    for (auto& mesh : model.meshes) {
+        if (mesh.vao != 0) continue;
+        if (uploadedAny && uploaded >= byteBudget) return false;
+        uploaded += uploadMesh(mesh);
+        uploadedAny = true;
+    }
+    
+    model.loaded = true;
     return true;
 }
 
@@ -1570,7 +1855,7 @@ void GLBLoader::cleanup(GLBModel& model) {
     // Clean up textures
     for (auto& texture : model.textures) {
         if (texture.textureId != 0) {
-            glDeleteTextures(1, &texture.textureId);
+            TextureRegistry::instance().release(texture.textureId);
             texture.textureId = 0;
         }
     }
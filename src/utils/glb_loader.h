@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <GL/glew.h>
+#include "skinning_kernels.h"
+#include "texture_codec.h"
 
 // Forward declaration
 namespace tinygltf {
@@ -19,7 +22,16 @@ struct GLBTexture {
     int height = 0;
     int channels = 0;
     std::string path;      // For debugging
-    bool loaded = false;
+    bool loaded = false;   // Image decoded (textureId is set once uploadGLB has run)
+    
+    // TextureRegistry keys: textureId is shared with every texture of the same content
+    uint64_t contentHash = 0;
+    std::string sourceKey; // Empty for embedded images
+    
+    // Mip chain waiting for uploadGLB (RGBA8 until compressTextures picks a format); freed after the
+    // upload. Empty for a loaded texture whose source was already resident in the registry.
+    TextureFormat format = TextureFormat::RGBA8;
+    std::vector<TextureLevel> stagedLevels;
 };
 
 // Structure to store a material from GLB file
@@ -58,6 +70,17 @@ struct GLBMesh {
     int materialIndex = -1;
     bool hasIndices = false;
     bool hasSkin = false;  // Whether this mesh has skinning data
+    
+    // Packed vertex layout: positions are 16-bit unorm, object position = posOffset + stored * posScale
+    bool packed = false;
+    glm::vec3 posOffset{0.0f};
+    glm::vec3 posScale{1.0f};
+    
+    // Interleaved vertex / joint / index data waiting for uploadGLB; freed after the upload
+    std::vector<float> stagedVertices;
+    std::vector<unsigned int> stagedJoints;
+    std::vector<unsigned int> stagedIndices;
+    int floatsPerVertex = 0;
 };
 
 // Structure to store a single joint in the skeleton
@@ -81,21 +104,35 @@ struct GLBSkin {
     std::string name;
     std::vector<GLBJoint> joints;          // All joints in the skeleton
     int rootJointIndex = -1;               // Index of root joint
+    std::vector<int> jointOrder;           // Joint indices with every parent before its children
     int skeletonRootNodeIndex = -1;        // Skeleton root node index (if specified in glTF)
-    std::vector<glm::mat4> boneMatrices;   // Final bone matrices for shader (computed)
     std::vector<glm::mat4> initialTransforms;  // Initial transforms for bind pose
     std::unordered_map<int, int> nodeToJointMap;  // Cached map: node index -> joint index (for performance)
+    std::vector<int> jointParents;                 // joints[i].parentIndex, flat for SkinningKernels
+    std::vector<glm::mat4> inverseBindMatrices;    // joints[i].inverseBindMatrix, flat for SkinningKernels
     glm::mat4 skeletonRootTransform{1.0f}; // Transform of skeleton root node (if specified)
+    bool skeletonRootInHierarchy = false;  // Skeleton root node is one of the joints (computed at load)
+    
+    // Rebuild nodeToJointMap, jointParents and inverseBindMatrices from joints
+    void rebuildLookups();
+};
+
+// Animated node property, classified from the glTF target path at load time
+enum class GLBChannelPath {
+    Translation,
+    Rotation,
+    Scale,
+    Unsupported                            // e.g. morph target "weights"; ignored during playback
 };
 
 // Structure to store animation channel data
 struct GLBAnimationChannel {
     int nodeIndex = -1;                    // Target node index
-    std::string path;                      // "translation", "rotation", or "scale"
+    GLBChannelPath path = GLBChannelPath::Unsupported;
     std::vector<float> times;              // Keyframe times
-    std::vector<glm::vec3> translations;  // Translation keyframes (if path == "translation")
-    std::vector<glm::quat> rotations;     // Rotation keyframes (if path == "rotation")
-    std::vector<glm::vec3> scales;        // Scale keyframes (if path == "scale")
+    std::vector<glm::vec3> translations;  // Translation keyframes (if path == Translation)
+    std::vector<glm::quat> rotations;     // Rotation keyframes (if path == Rotation)
+    std::vector<glm::vec3> scales;        // Scale keyframes (if path == Scale)
     int interpolation = 0;                 // 0=LINEAR, 1=STEP, 2=CUBICSPLINE
 };
 
@@ -110,7 +147,7 @@ struct GLBAnimation {
 struct GLBModel {
     std::vector<GLBMesh> meshes;
     std::string filepath;
-    bool loaded = false;
+    bool loaded = false;   // Parsed and fully uploaded to the GPU
     
     // Material and texture data (Stage 3)
     std::vector<GLBMaterial> materials;
@@ -124,6 +161,46 @@ struct GLBModel {
     std::vector<GLBAnimation> animations;
 };
 
+// Local joint transform as translation / rotation / scale, the form clips are sampled in
+struct GLBJointTRS {
+    glm::vec3 t{0.0f};
+    glm::quat r{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 s{1.0f};
+};
+
+// One clip contributing to a pose
+struct GLBClipLayer {
+    int animationIndex = -1;               // -1 or out of range: layer is skipped
+    float time = 0.0f;                     // Seconds; wrapped into the clip if loop, clamped to it otherwise
+    float weight = 1.0f;                   // Relative weight, normalized over the evaluated layers
+    bool loop = true;
+    
+    bool operator==(const GLBClipLayer& other) const = default;
+};
+
+// Animation state of one drawn instance of a GLBModel. The model (meshes, skeleton, clips) is shared
+// by every instance and only read during playback, so any number of instances can pose independently.
+// Every buffer is sized on the first evaluation and reused afterwards (no per-frame allocation).
+struct GLBPose {
+    int animationIndex = -1;               // Clip played by updateAnimation (-1: bind pose)
+    float time = 0.0f;                     // Its time as last passed in, in seconds
+    bool loop = true;
+    
+    // Crossfade applied by updateAnimation when the clip changes
+    float crossfadeSeconds = 0.25f;        // 0 cuts straight to the new clip
+    int fadeFromAnimation = -1;            // Clip fading out (-1: no fade in progress)
+    float fadeFromTime = 0.0f;
+    bool fadeFromLoop = true;
+    float fadeElapsed = 0.0f;
+    
+    // Clip time kept running by the caller once its timeline stops (-1: following the timeline)
+    float continuedTime = -1.0f;
+    
+    std::vector<std::vector<size_t>> clipCursors;   // Keyframe cursor per clip and channel
+    JointPoseSoA joints;                   // Blended local pose
+    std::vector<glm::vec4> palette;        // Skinning matrices for the shader as 3x4 rows, 3 entries per joint
+};
+
 // GLB file loader class
 class GLBLoader {
 public:
@@ -133,6 +210,16 @@ public:
     // @return true if loading succeeded, false otherwise
     static bool loadGLB(const std::string& filepath, GLBModel& model);
     
+    // CPU stage of loadGLB: parse the file, decode textures and build vertex data, without any GL
+    // calls. Safe to run on a worker thread; the result is uploaded later with uploadGLB.
+    // @return true if parsing succeeded
+    static bool parseGLB(const std::string& filepath, GLBModel& model);
+    
+    // GL stage of loadGLB: upload staged meshes and textures of a parsed model, stopping once about
+    // byteBudget bytes went to the GPU (at least one item is uploaded per call). Needs a current context.
+    // @return true once everything is uploaded (model.loaded is then set)
+    static bool uploadGLB(GLBModel& model, size_t byteBudget = SIZE_MAX);
+    
     // Clean up OpenGL resources for a model
     // @param model Model to clean up
     static void cleanup(GLBModel& model);
@@ -142,11 +229,28 @@ public:
     static void printModelInfo(const GLBModel& model);
     
     // Update animation and compute bone matrices (Stage 6-7)
-    // @param model Model to update
-    // @param currentTime Current animation time in seconds
-    // @param animationIndex Index of animation to play (-1 for no animation)
+    // When clip.animationIndex differs from the clip pose played last, the old clip keeps running
+    // and fades out over pose.crossfadeSeconds of deltaSec (no progress while deltaSec is 0).
+    // @param model Model to evaluate (not modified)
+    // @param pose Instance state receiving the bone matrices
+    // @param clip Clip to play (animationIndex -1 for the bind pose); its weight is ignored
+    // @param deltaSec Seconds since the previous update of this pose
     // @param ignoreRootTranslation If true, ignore translation on root joint
     // @return true if update succeeded
-    static bool updateAnimation(GLBModel& model, float currentTime, int animationIndex = 0, bool ignoreRootTranslation = false);
+    static bool updateAnimation(const GLBModel& model, GLBPose& pose, const GLBClipLayer& clip, float deltaSec = 0.0f,
+                                bool ignoreRootTranslation = false);
+    
+    // First half of updateAnimation: advance the pose's clip and crossfade state and write the layers
+    // to evaluate into outLayers, without evaluating them. Poses whose layers compare equal (same
+    // model and root option) evaluate to the same palette, so callers can evaluate one and copy it.
+    // @return number of layers written (1 or 2)
+    static size_t advanceClips(const GLBModel& model, GLBPose& pose, const GLBClipLayer& clip, float deltaSec,
+                               GLBClipLayer outLayers[2]);
+    
+    // Sample layerCount clips, blend them by weight (linear T / S, nlerp R) into pose.joints and
+    // compute the bone matrices. With no usable layer the pose is the bind pose.
+    // Leaves pose.animationIndex and the crossfade state alone.
+    static bool evaluateClips(const GLBModel& model, GLBPose& pose, const GLBClipLayer* layers, size_t layerCount,
+                              bool ignoreRootTranslation = false);
 };
 
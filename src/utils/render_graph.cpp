@@ -0,0 +1,241 @@
+#include "render_graph.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // Pool textures nobody used for this many frames are freed
+    constexpr long kPoolIdleFrames = 120;
+
+    bool isDepthFormat(GLenum format) {
+        return format == GL_DEPTH_COMPONENT16 || format == GL_DEPTH_COMPONENT24 ||
+               format == GL_DEPTH_COMPONENT32F;
+    }
+}
+
+void RenderGraph::cleanupGL() {
+    for (auto &[textures, fbo] : m_framebuffers) {
+        glDeleteFramebuffers(1, &fbo);
+    }
+    m_framebuffers.clear();
+    for (PoolEntry &entry : m_pool) {
+        glDeleteTextures(1, &entry.texture);
+    }
+    m_pool.clear();
+    m_resources.clear();
+    m_passes.clear();
+}
+
+void RenderGraph::setOutputSize(int width, int height) {
+    glm::ivec2 size(std::max(width, 1), std::max(height, 1));
+    m_outputSize = size;
+}
+
+RenderGraph::Resource RenderGraph::create(const std::string &name, const RenderTargetDesc &desc) {
+    ResourceNode node;
+    node.name = name;
+    node.desc = desc;
+    m_resources.push_back(node);
+    return static_cast<Resource>(m_resources.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::importFramebuffer(const std::string &name, GLuint fbo, int width, int height) {
+    ResourceNode node;
+    node.name = name;
+    node.imported = true;
+    node.fbo = fbo;
+    node.size = glm::ivec2(width, height);
+    m_resources.push_back(node);
+    return static_cast<Resource>(m_resources.size() - 1);
+}
+
+void RenderGraph::addPass(const std::string &name, std::vector<Resource> reads, std::vector<Resource> writes,
+                          std::function<void()> execute) {
+    m_passes.push_back({name, std::move(reads), std::move(writes), std::move(execute)});
+}
+
+void RenderGraph::execute() {
+    ++m_frame;
+    m_executed.clear();
+    const size_t passCount = m_passes.size();
+
+    // Walk back from the passes that write imported targets; everything they read is needed,
+    // and so is every earlier pass writing something needed
+    std::vector<bool> live(passCount, false);
+    std::vector<bool> needed(m_resources.size(), false);
+    for (size_t p = passCount; p-- > 0;) {
+        const PassNode &pass = m_passes[p];
+        bool keep = false;
+        for (Resource w : pass.writes) {
+            keep = keep || m_resources[w].imported || needed[w];
+        }
+        if (!keep) continue;
+        live[p] = true;
+        for (Resource r : pass.reads) needed[r] = true;
+    }
+
+    // Lifetime of each transient: first to last live pass touching it
+    std::vector<int> first(m_resources.size(), -1), last(m_resources.size(), -1);
+    for (size_t p = 0; p < passCount; ++p) {
+        if (!live[p]) continue;
+        for (const auto *list : {&m_passes[p].reads, &m_passes[p].writes}) {
+            for (Resource r : *list) {
+                if (first[r] < 0) first[r] = static_cast<int>(p);
+                last[r] = static_cast<int>(p);
+            }
+        }
+    }
+
+    for (size_t p = 0; p < passCount; ++p) {
+        if (!live[p]) continue;
+        const PassNode &pass = m_passes[p];
+
+        for (const auto *list : {&pass.reads, &pass.writes}) {
+            for (Resource r : *list) {
+                ResourceNode &node = m_resources[r];
+                if (node.imported || first[r] != static_cast<int>(p) || node.pooled >= 0) continue;
+                node.size = resolveSize(node.desc);
+                node.pooled = acquire(node.desc.format, node.size);
+            }
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebufferFor(pass));
+        if (!pass.writes.empty()) {
+            glm::ivec2 viewport = m_resources[pass.writes.front()].size;
+            glViewport(0, 0, viewport.x, viewport.y);
+        }
+        pass.execute();
+        m_executed.push_back(pass.name);
+
+        // Targets past their last use go back to the pool for later passes to alias
+        for (const auto *list : {&pass.reads, &pass.writes}) {
+            for (Resource r : *list) {
+                ResourceNode &node = m_resources[r];
+                if (node.imported || last[r] != static_cast<int>(p) || node.pooled < 0) continue;
+                m_pool[node.pooled].inUse = false;
+                node.pooled = -1;
+            }
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // Every (format, size) declared this frame, culled targets included, so they stay pooled
+    std::vector<std::pair<GLenum, glm::ivec2>> declared;
+    for (const ResourceNode &node : m_resources) {
+        if (!node.imported) declared.emplace_back(node.desc.format, resolveSize(node.desc));
+    }
+
+    m_resources.clear();
+    m_passes.clear();
+    releaseUnused(declared);
+}
+
+GLuint RenderGraph::texture(Resource resource) const {
+    const ResourceNode &node = m_resources[resource];
+    return node.pooled >= 0 ? m_pool[node.pooled].texture : 0;
+}
+
+glm::ivec2 RenderGraph::size(Resource resource) const {
+    return m_resources[resource].size;
+}
+
+glm::ivec2 RenderGraph::resolveSize(const RenderTargetDesc &desc) const {
+    return glm::max(glm::ivec2(glm::vec2(m_outputSize) * desc.scale), glm::ivec2(1));
+}
+
+int RenderGraph::acquire(GLenum format, glm::ivec2 size) {
+    for (size_t i = 0; i < m_pool.size(); ++i) {
+        PoolEntry &entry = m_pool[i];
+        if (entry.inUse || entry.format != format || entry.size != size) continue;
+        entry.inUse = true;
+        entry.lastUsedFrame = m_frame;
+        return static_cast<int>(i);
+    }
+
+    PoolEntry entry;
+    entry.format = format;
+    entry.size = size;
+    entry.inUse = true;
+    entry.lastUsedFrame = m_frame;
+    glGenTextures(1, &entry.texture);
+    glBindTexture(GL_TEXTURE_2D, entry.texture);
+    if (isDepthFormat(format)) {
+        glTexImage2D(GL_TEXTURE_2D, 0, format, size.x, size.y, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, format, size.x, size.y, 0, GL_RGBA, GL_FLOAT, NULL);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_pool.push_back(entry);
+    return static_cast<int>(m_pool.size() - 1);
+}
+
+GLuint RenderGraph::framebufferFor(const PassNode &pass) {
+    std::vector<GLuint> textures;
+    for (Resource w : pass.writes) {
+        const ResourceNode &node = m_resources[w];
+        if (node.imported) return node.fbo;
+        textures.push_back(m_pool[node.pooled].texture);
+    }
+    if (textures.empty()) return 0;
+
+    auto it = m_framebuffers.find(textures);
+    if (it != m_framebuffers.end()) return it->second;
+
+    GLuint fbo = 0;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    std::vector<GLenum> drawBuffers;
+    for (Resource w : pass.writes) {
+        const ResourceNode &node = m_resources[w];
+        GLuint texture = m_pool[node.pooled].texture;
+        if (isDepthFormat(node.desc.format)) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+        } else {
+            GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(drawBuffers.size());
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture, 0);
+            drawBuffers.push_back(attachment);
+        }
+    }
+    if (drawBuffers.empty()) {
+        glDrawBuffer(GL_NONE);
+    } else {
+        glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    }
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "RenderGraph: framebuffer of pass " << pass.name << " is NOT complete!" << std::endl;
+    }
+
+    m_framebuffers.emplace(std::move(textures), fbo);
+    return fbo;
+}
+
+// Free pool textures this frame didn't use: right away when nothing declared this frame has their
+// format and size (after a resize or a target's scale change), otherwise once they've sat idle for
+// kPoolIdleFrames
+void RenderGraph::releaseUnused(const std::vector<std::pair<GLenum, glm::ivec2>> &declared) {
+    for (size_t i = m_pool.size(); i-- > 0;) {
+        const PoolEntry &entry = m_pool[i];
+        const long idle = m_frame - entry.lastUsedFrame;
+        if (idle == 0) continue;
+        const bool stillDeclared = std::any_of(declared.begin(), declared.end(), [&](const auto &d) {
+            return d.first == entry.format && d.second == entry.size;
+        });
+        if (stillDeclared && idle < kPoolIdleFrames) continue;
+
+        for (auto it = m_framebuffers.begin(); it != m_framebuffers.end();) {
+            if (std::find(it->first.begin(), it->first.end(), entry.texture) != it->first.end()) {
+                glDeleteFramebuffers(1, &it->second);
+                it = m_framebuffers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        glDeleteTextures(1, &entry.texture);
+        m_pool.erase(m_pool.begin() + static_cast<long>(i));
+    }
+}
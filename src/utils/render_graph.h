@@ -0,0 +1,104 @@
+#pragma once
+
+// Defined before including GLEW to suppress deprecation messages on macOS
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+#include <GL/glew.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+// A transient 2D target, sized relative to the graph's output
+struct RenderTargetDesc {
+    GLenum format = GL_RGBA16F;   // any colour-renderable format, or GL_DEPTH_COMPONENT24 for depth
+    float scale = 1.0f;           // of the output size per axis, rounded down (at least 1x1)
+};
+
+/**
+ * Per-frame graph of full-screen passes. Each frame the caller declares its targets and passes (with
+ * the targets each one reads and writes) and then calls execute(), which
+ *
+ *  - culls every pass whose writes nothing live reads; passes writing an imported target (the
+ *    screen) are what keeps the rest alive,
+ *  - gives each transient target a texture from a pool for the span of passes between its first and
+ *    last use, so targets whose spans don't overlap share (alias) one texture of matching format and
+ *    size,
+ *  - binds a framebuffer with the pass's written targets attached (depth formats on the depth
+ *    attachment) and sets the viewport to their size before running the pass's callback.
+ *
+ * A pass that blends into a target written earlier should also list it as a read, so that the
+ * earlier contents stay alive up to it. Transient contents are undefined when a pass first writes
+ * them; the pass clears what it needs. Pool textures follow setOutputSize() (and changes to a
+ * target's scale) on their next use: unused ones whose size nothing declares any more are freed right
+ * away, others once left unused for a while, so resize is handled here and nowhere else.
+ */
+class RenderGraph {
+public:
+    using Resource = int;
+
+    // Needs a current GL context
+    void cleanupGL();
+
+    void setOutputSize(int width, int height);
+    glm::ivec2 outputSize() const { return m_outputSize; }
+
+    // Declarations, valid until the end of the next execute()
+    Resource create(const std::string &name, const RenderTargetDesc &desc);
+    Resource importFramebuffer(const std::string &name, GLuint fbo, int width, int height);
+    void addPass(const std::string &name, std::vector<Resource> reads, std::vector<Resource> writes,
+                 std::function<void()> execute);
+
+    // Cull, allocate and run the declared passes in order, then clear the declarations
+    void execute();
+
+    // Inside a pass callback: texture / size of a target the pass reads or writes
+    GLuint texture(Resource resource) const;
+    glm::ivec2 size(Resource resource) const;
+
+    // Passes run by the last execute(), and pool textures currently allocated
+    const std::vector<std::string> &executedPasses() const { return m_executed; }
+    size_t pooledTextureCount() const { return m_pool.size(); }
+
+private:
+    struct ResourceNode {
+        std::string name;
+        RenderTargetDesc desc;
+        bool imported = false;
+        GLuint fbo = 0;              // imported only
+        glm::ivec2 size{0};
+        int pooled = -1;             // index into m_pool while allocated
+    };
+
+    struct PassNode {
+        std::string name;
+        std::vector<Resource> reads;
+        std::vector<Resource> writes;
+        std::function<void()> execute;
+    };
+
+    struct PoolEntry {
+        GLuint texture = 0;
+        GLenum format = 0;
+        glm::ivec2 size{0};
+        bool inUse = false;
+        long lastUsedFrame = 0;
+    };
+
+    glm::ivec2 resolveSize(const RenderTargetDesc &desc) const;
+    int acquire(GLenum format, glm::ivec2 size);
+    GLuint framebufferFor(const PassNode &pass);
+    void releaseUnused(const std::vector<std::pair<GLenum, glm::ivec2>> &declared);
+
+    glm::ivec2 m_outputSize{1};
+    std::vector<ResourceNode> m_resources;
+    std::vector<PassNode> m_passes;
+    std::vector<PoolEntry> m_pool;
+    std::map<std::vector<GLuint>, GLuint> m_framebuffers;   // attached textures -> FBO
+    std::vector<std::string> m_executed;
+    long m_frame = 0;
+};
@@ -7,7 +7,51 @@
 #include <GL/glew.h>
 #include <QFile>
 #include <QTextStream>
+#include <algorithm>
 #include <iostream>
+#include <string>
+#include <unordered_map>
+
+// Locations of the active uniforms of a linked program, reflected once after linking
+class UniformTable {
+public:
+    void reflect(GLuint programID) {
+        m_locations.clear();
+
+        GLint count = 0;
+        GLint maxLength = 0;
+        glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+        std::string buffer(std::max(maxLength, 1), '\0');
+        for (GLint i = 0; i < count; ++i) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(programID, i, maxLength, &length, &size, &type, &buffer[0]);
+            std::string name(buffer.data(), length);
+
+            // Uniform block members have no location
+            GLint location = glGetUniformLocation(programID, name.c_str());
+            if (location == -1) continue;
+            m_locations[name] = location;
+
+            // Arrays are reported as "name[0]"; also register the bare name
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+                m_locations[name.substr(0, name.size() - 3)] = location;
+            }
+        }
+    }
+
+    // Location of a uniform, or -1 if the program has no such active uniform
+    GLint location(const std::string &name) const {
+        auto it = m_locations.find(name);
+        return it != m_locations.end() ? it->second : -1;
+    }
+
+private:
+    std::unordered_map<std::string, GLint> m_locations;
+};
 
 class ShaderLoader{
 public:
@@ -41,10 +85,29 @@ public:
         glDeleteShader(vertexShaderID);
         glDeleteShader(fragmentShaderID);
 
+        // Reflect uniform locations once so draw loops never look them up by string
+        tables()[programID].reflect(programID);
+
         return programID;
     }
 
+    // Reflected uniform table of a program created by createShaderProgram
+    static const UniformTable &uniforms(GLuint programID) {
+        return tables()[programID];
+    }
+
+    // Delete a program and forget its uniform table
+    static void deleteShaderProgram(GLuint programID) {
+        tables().erase(programID);
+        glDeleteProgram(programID);
+    }
+
 private:
+    static std::unordered_map<GLuint, UniformTable> &tables() {
+        static std::unordered_map<GLuint, UniformTable> programTables;
+        return programTables;
+    }
+
     static GLuint createShader(GLenum shaderType, const char *filepath){
         GLuint shaderID = glCreateShader(shaderType);
 
@@ -0,0 +1,208 @@
+#include "skinning_kernels.h"
+
+#include <algorithm>
+
+// SKINNING_FORCE_SCALAR builds the plain-float fallback on any target (the kernel tests use it)
+#if defined(SKINNING_FORCE_SCALAR)
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SKINNING_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SKINNING_NEON 1
+#endif
+
+namespace {
+// Four-lane float vector on whichever instruction set is available
+#if SKINNING_SSE2
+using F4 = __m128;
+inline F4 load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, F4 v) { _mm_storeu_ps(p, v); }
+inline F4 splat(float v) { return _mm_set1_ps(v); }
+inline F4 add(F4 a, F4 b) { return _mm_add_ps(a, b); }
+inline F4 sub(F4 a, F4 b) { return _mm_sub_ps(a, b); }
+inline F4 mul(F4 a, F4 b) { return _mm_mul_ps(a, b); }
+inline void transpose(F4& a, F4& b, F4& c, F4& d) { _MM_TRANSPOSE4_PS(a, b, c, d); }
+template <int Lane> inline F4 broadcast(F4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane)); }
+#elif SKINNING_NEON
+using F4 = float32x4_t;
+inline F4 load(const float* p) { return vld1q_f32(p); }
+inline void store(float* p, F4 v) { vst1q_f32(p, v); }
+inline F4 splat(float v) { return vdupq_n_f32(v); }
+inline F4 add(F4 a, F4 b) { return vaddq_f32(a, b); }
+inline F4 sub(F4 a, F4 b) { return vsubq_f32(a, b); }
+inline F4 mul(F4 a, F4 b) { return vmulq_f32(a, b); }
+inline void transpose(F4& a, F4& b, F4& c, F4& d) {
+    float32x4x2_t ab = vtrnq_f32(a, b);
+    float32x4x2_t cd = vtrnq_f32(c, d);
+    a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+    b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+    c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+    d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+template <int Lane> inline F4 broadcast(F4 v) { return vdupq_laneq_f32(v, Lane); }
+#else
+struct F4 {
+    float v[4];
+};
+inline F4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store(float* p, F4 a) { std::copy(a.v, a.v + 4, p); }
+inline F4 splat(float v) { return {{v, v, v, v}}; }
+inline F4 add(F4 a, F4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline F4 sub(F4 a, F4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+inline F4 mul(F4 a, F4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline void transpose(F4& a, F4& b, F4& c, F4& d) {
+    F4 r[4] = {a, b, c, d};
+    for (int i = 0; i < 4; ++i) {
+        a.v[i] = r[i].v[0];
+        b.v[i] = r[i].v[1];
+        c.v[i] = r[i].v[2];
+        d.v[i] = r[i].v[3];
+    }
+}
+template <int Lane> inline F4 broadcast(F4 v) { return splat(v.v[Lane]); }
+#endif
+
+// a * column, column being one column of a column-major 4x4 matrix
+inline F4 transformColumn(F4 a0, F4 a1, F4 a2, F4 a3, F4 column) {
+    F4 out = mul(a0, broadcast<0>(column));
+    out = add(out, mul(a1, broadcast<1>(column)));
+    out = add(out, mul(a2, broadcast<2>(column)));
+    return add(out, mul(a3, broadcast<3>(column)));
+}
+
+// out = a * b where b is affine (last row 0 0 0 1): the w terms drop out of the linear columns
+inline void multiplyAffine(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+    const F4 a0 = load(&a[0][0]), a1 = load(&a[1][0]), a2 = load(&a[2][0]), a3 = load(&a[3][0]);
+    for (int c = 0; c < 3; ++c) {
+        const F4 column = load(&b[c][0]);
+        F4 result = mul(a0, broadcast<0>(column));
+        result = add(result, mul(a1, broadcast<1>(column)));
+        store(&out[c][0], add(result, mul(a2, broadcast<2>(column))));
+    }
+    store(&out[3][0], transformColumn(a0, a1, a2, a3, load(&b[3][0])));
+}
+}
+
+void JointPoseSoA::resize(size_t count) {
+    m_count = count;
+    const size_t padded = (count + 3) & ~size_t(3);
+    for (auto* v : {&tx, &ty, &tz, &rx, &ry, &rz}) v->resize(padded, 0.0f);
+    for (auto* v : {&rw, &sx, &sy, &sz}) v->resize(padded, 1.0f);
+}
+
+void JointPoseSoA::set(size_t i, const glm::vec3& t, const glm::quat& r, const glm::vec3& s) {
+    tx[i] = t.x;
+    ty[i] = t.y;
+    tz[i] = t.z;
+    rx[i] = r.x;
+    ry[i] = r.y;
+    rz[i] = r.z;
+    rw[i] = r.w;
+    sx[i] = s.x;
+    sy[i] = s.y;
+    sz[i] = s.z;
+}
+
+void SkinningKernels::composeLocals(const JointPoseSoA& poses, glm::mat4* outLocals) {
+    const size_t count = poses.size();
+    const F4 one = splat(1.0f), two = splat(2.0f), zero = splat(0.0f);
+
+    for (size_t j = 0; j < count; j += 4) {
+        const F4 x = load(&poses.rx[j]), y = load(&poses.ry[j]), z = load(&poses.rz[j]), w = load(&poses.rw[j]);
+        const F4 sx = load(&poses.sx[j]), sy = load(&poses.sy[j]), sz = load(&poses.sz[j]);
+
+        // Same terms as glm::mat4_cast, four quaternions at once
+        const F4 xx = mul(x, x), yy = mul(y, y), zz = mul(z, z);
+        const F4 xy = mul(x, y), xz = mul(x, z), yz = mul(y, z);
+        const F4 wx = mul(w, x), wy = mul(w, y), wz = mul(w, z);
+
+        // Rows of each column for four joints; the transposes turn them into per-joint columns
+        F4 c0[4] = {mul(sub(one, mul(two, add(yy, zz))), sx), mul(mul(two, add(xy, wz)), sx),
+                    mul(mul(two, sub(xz, wy)), sx), zero};
+        F4 c1[4] = {mul(mul(two, sub(xy, wz)), sy), mul(sub(one, mul(two, add(xx, zz))), sy),
+                    mul(mul(two, add(yz, wx)), sy), zero};
+        F4 c2[4] = {mul(mul(two, add(xz, wy)), sz), mul(mul(two, sub(yz, wx)), sz),
+                    mul(sub(one, mul(two, add(xx, yy))), sz), zero};
+        F4 c3[4] = {load(&poses.tx[j]), load(&poses.ty[j]), load(&poses.tz[j]), one};
+        transpose(c0[0], c0[1], c0[2], c0[3]);
+        transpose(c1[0], c1[1], c1[2], c1[3]);
+        transpose(c2[0], c2[1], c2[2], c2[3]);
+        transpose(c3[0], c3[1], c3[2], c3[3]);
+
+        const size_t lanes = std::min<size_t>(4, count - j);
+        for (size_t k = 0; k < lanes; ++k) {
+            glm::mat4& local = outLocals[j + k];
+            store(&local[0][0], c0[k]);
+            store(&local[1][0], c1[k]);
+            store(&local[2][0], c2[k]);
+            store(&local[3][0], c3[k]);
+        }
+    }
+}
+
+void SkinningKernels::composeLocalsScalar(const JointPoseSoA& poses, glm::mat4* outLocals) {
+    for (size_t j = 0; j < poses.size(); ++j) {
+        glm::vec3 s = poses.scale(j);
+        glm::mat4 local = glm::mat4_cast(poses.rotation(j));
+        local[0] *= s.x;
+        local[1] *= s.y;
+        local[2] *= s.z;
+        local[3] = glm::vec4(poses.translation(j), 1.0f);
+        outLocals[j] = local;
+    }
+}
+
+void SkinningKernels::composeGlobals(const glm::mat4* locals, const int* parents, const int* order, size_t count,
+                                     const glm::mat4& rootTransform, glm::mat4* outGlobals) {
+    for (size_t i = 0; i < count; ++i) {
+        const int j = order[i];
+        const glm::mat4& parent = parents[j] >= 0 ? outGlobals[parents[j]] : rootTransform;
+        multiplyAffine(parent, locals[j], outGlobals[j]);
+    }
+}
+
+void SkinningKernels::composeGlobalsScalar(const glm::mat4* locals, const int* parents, const int* order,
+                                           size_t count, const glm::mat4& rootTransform, glm::mat4* outGlobals) {
+    for (size_t i = 0; i < count; ++i) {
+        const int j = order[i];
+        outGlobals[j] = (parents[j] >= 0 ? outGlobals[parents[j]] : rootTransform) * locals[j];
+    }
+}
+
+void SkinningKernels::composePalette(const glm::mat4* globals, const glm::mat4* inverseBinds, size_t count,
+                                     glm::vec4* outRows) {
+    for (size_t j = 0; j < count; ++j) {
+        const glm::mat4& a = globals[j];
+        const glm::mat4& b = inverseBinds[j];
+        const F4 a0 = load(&a[0][0]), a1 = load(&a[1][0]), a2 = load(&a[2][0]), a3 = load(&a[3][0]);
+        F4 c0 = transformColumn(a0, a1, a2, a3, load(&b[0][0]));
+        F4 c1 = transformColumn(a0, a1, a2, a3, load(&b[1][0]));
+        F4 c2 = transformColumn(a0, a1, a2, a3, load(&b[2][0]));
+        F4 c3 = transformColumn(a0, a1, a2, a3, load(&b[3][0]));
+        transpose(c0, c1, c2, c3);   // columns -> rows; the fourth row is 0 0 0 1 and is not stored
+        store(&outRows[3 * j][0], c0);
+        store(&outRows[3 * j + 1][0], c1);
+        store(&outRows[3 * j + 2][0], c2);
+    }
+}
+
+void SkinningKernels::composePaletteScalar(const glm::mat4* globals, const glm::mat4* inverseBinds, size_t count,
+                                           glm::vec4* outRows) {
+    for (size_t j = 0; j < count; ++j) {
+        const glm::mat4 rows = glm::transpose(globals[j] * inverseBinds[j]);
+        outRows[3 * j] = rows[0];
+        outRows[3 * j + 1] = rows[1];
+        outRows[3 * j + 2] = rows[2];
+    }
+}
+
+const char* SkinningKernels::backend() {
+#if SKINNING_SSE2
+    return "SSE2";
+#elif SKINNING_NEON
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
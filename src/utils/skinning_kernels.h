@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Joint poses as structure-of-arrays, so the kernels read four joints per register.
+// Storage is padded to a multiple of four with identity transforms; only the first size() are used.
+struct JointPoseSoA {
+    std::vector<float> tx, ty, tz;
+    std::vector<float> rx, ry, rz, rw;     // unit quaternions
+    std::vector<float> sx, sy, sz;
+
+    size_t size() const { return m_count; }
+    void resize(size_t count);
+
+    void set(size_t i, const glm::vec3& t, const glm::quat& r, const glm::vec3& s);
+    glm::vec3 translation(size_t i) const { return {tx[i], ty[i], tz[i]}; }
+    glm::quat rotation(size_t i) const { return {rw[i], rx[i], ry[i], rz[i]}; }
+    glm::vec3 scale(size_t i) const { return {sx[i], sy[i], sz[i]}; }
+
+private:
+    size_t m_count = 0;
+};
+
+/**
+ * Batch kernels turning joint poses into a skinning palette, on SSE2 (x86-64) or NEON (ARM) and
+ * on plain floats elsewhere (SkinningKernels::backend() names the one compiled in). Each has a
+ * *Scalar twin built from glm one joint at a time; the two agree to float rounding and the scalar
+ * ones are kept as the reference when the vector code changes (tests/skinning_kernels_test.cpp).
+ */
+class SkinningKernels {
+public:
+    // outLocals[j] = T * R * S of joint j, four joints per iteration
+    static void composeLocals(const JointPoseSoA& poses, glm::mat4* outLocals);
+    static void composeLocalsScalar(const JointPoseSoA& poses, glm::mat4* outLocals);
+
+    // outGlobals[j] = outGlobals[parents[j]] * locals[j] along order (every parent before its
+    // children); roots (parent -1) use rootTransform as their parent. Locals must be affine
+    // (last row 0 0 0 1), as TRS compositions and glTF node matrices are.
+    static void composeGlobals(const glm::mat4* locals, const int* parents, const int* order, size_t count,
+                               const glm::mat4& rootTransform, glm::mat4* outGlobals);
+    static void composeGlobalsScalar(const glm::mat4* locals, const int* parents, const int* order, size_t count,
+                                     const glm::mat4& rootTransform, glm::mat4* outGlobals);
+
+    // globals[j] * inverseBinds[j] as a 3x4 palette entry: its first three rows, stored at
+    // outRows[3j .. 3j+2]. The dropped row is always 0 0 0 1 since both inputs are affine.
+    static void composePalette(const glm::mat4* globals, const glm::mat4* inverseBinds, size_t count,
+                               glm::vec4* outRows);
+    static void composePaletteScalar(const glm::mat4* globals, const glm::mat4* inverseBinds, size_t count,
+                                     glm::vec4* outRows);
+
+    static const char* backend();
+};
@@ -1,7 +1,10 @@
 #include "tessellator.h" 
 
 #include <algorithm> 
+#include <array> 
 #include <cmath> 
+#include <cstring> 
+#include <unordered_map> 
 #include <glm/gtc/constants.hpp> 
 
 namespace { 
@@ -22,6 +25,44 @@ namespace {
         float zNorm = 2.0f * pt.z; 
         return glm::normalize(glm::vec3{xNorm, yNorm, zNorm}); 
     } 
+
+    // ---- indexed output ---- 
+    constexpr int FLOATS_PER_VERTEX = 6; 
+    constexpr size_t VERTEX_CACHE_SIZE = 32;   // entries of the LRU cache the optimizer simulates (Forsyth's size) 
+
+    struct VertexKey { 
+        std::array<float, FLOATS_PER_VERTEX> values; 
+        bool operator==(const VertexKey &other) const { return values == other.values; } 
+    }; 
+
+    struct VertexKeyHash { 
+        size_t operator()(const VertexKey &key) const { 
+            size_t h = 0; 
+            for (float f : key.values) { 
+                uint32_t bits; 
+                std::memcpy(&bits, &f, sizeof(bits)); 
+                h = h * 1000003u ^ bits; 
+            } 
+            return h; 
+        } 
+    }; 
+
+    // Forsyth's vertex score: cache recency plus a boost for vertices with few triangles left 
+    inline float cacheVertexScore(int cachePosition, uint32_t remainingTriangles) { 
+        if (remainingTriangles == 0) return -1.0f; 
+
+        float score = 0.0f; 
+        if (cachePosition >= 0) { 
+            if (cachePosition < 3) { 
+                score = 0.75f;   // vertices of the triangle just emitted share one fixed score 
+            } else { 
+                float scaler = 1.0f / (VERTEX_CACHE_SIZE - 3); 
+                score = std::pow(1.0f - (cachePosition - 3) * scaler, 1.5f); 
+            } 
+        } 
+        score += 2.0f * std::pow(static_cast<float>(remainingTriangles), -0.5f); 
+        return score; 
+    } 
 } 
 
 void Tessellator::generateCube(std::vector<float> &vertices, int param1) { 
@@ -352,6 +393,174 @@ void Tessellator::generateCylinder(std::vector<float> &vertices, int param1, int
     } 
 } 
 
+void Tessellator::buildIndexedMesh(const std::vector<float> &triangleSoup, 
+                                   std::vector<float> &vertices, 
+                                   std::vector<uint32_t> &indices) { 
+    vertices.clear(); 
+    indices.clear(); 
+
+    const size_t soupVertexCount = triangleSoup.size() / FLOATS_PER_VERTEX; 
+    indices.reserve(soupVertexCount); 
+
+    // ---- weld: identical position + normal collapse into one vertex ---- 
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> lookup; 
+    lookup.reserve(soupVertexCount); 
+    std::vector<float> welded; 
+    welded.reserve(triangleSoup.size()); 
+
+    for (size_t v = 0; v < soupVertexCount; ++v) { 
+        VertexKey key; 
+        for (int k = 0; k < FLOATS_PER_VERTEX; ++k) { 
+            // + 0.0f folds -0.0 into 0.0 so both hash and compare equal 
+            key.values[k] = triangleSoup[v * FLOATS_PER_VERTEX + k] + 0.0f; 
+        } 
+
+        auto [it, inserted] = lookup.emplace(key, static_cast<uint32_t>(welded.size() / FLOATS_PER_VERTEX)); 
+        if (inserted) { 
+            welded.insert(welded.end(), key.values.begin(), key.values.end()); 
+        } 
+        indices.push_back(it->second); 
+
+        // pole and apex triangles weld down to zero area; they draw nothing, so drop them 
+        if (v % 3 == 2) { 
+            const size_t base = indices.size() - 3; 
+            if (indices[base] == indices[base + 1] || indices[base + 1] == indices[base + 2] 
+                || indices[base] == indices[base + 2]) { 
+                indices.resize(base); 
+            } 
+        } 
+    } 
+
+    const size_t uniqueCount = welded.size() / FLOATS_PER_VERTEX; 
+    optimizeVertexCache(indices, uniqueCount); 
+
+    // ---- renumber vertices in first-use order so vertex fetch walks memory forward ---- 
+    std::vector<uint32_t> remap(uniqueCount, UINT32_MAX); 
+    uint32_t next = 0; 
+    vertices.resize(welded.size()); 
+    for (uint32_t &index : indices) { 
+        if (remap[index] == UINT32_MAX) { 
+            remap[index] = next; 
+            std::copy_n(welded.begin() + index * FLOATS_PER_VERTEX, FLOATS_PER_VERTEX, 
+                        vertices.begin() + next * FLOATS_PER_VERTEX); 
+            ++next; 
+        } 
+        index = remap[index]; 
+    } 
+    vertices.resize(static_cast<size_t>(next) * FLOATS_PER_VERTEX); 
+} 
+
+// Greedy triangle reordering after Forsyth, "Linear-Speed Vertex Cache Optimisation": 
+// every step emits the unemitted triangle whose vertices score highest, where a vertex 
+// scores for sitting near the front of a simulated VERTEX_CACHE_SIZE (32) entry LRU cache 
+// and for having few triangles left (so fans get finished instead of leaving stragglers 
+// behind). 
+void Tessellator::optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount) { 
+    const size_t triangleCount = indices.size() / 3; 
+    if (triangleCount == 0) return; 
+
+    // vertex -> adjacent triangles, stored as one flat array with offsets 
+    std::vector<uint32_t> remaining(vertexCount, 0); 
+    for (uint32_t index : indices) ++remaining[index]; 
+
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0); 
+    for (size_t v = 0; v < vertexCount; ++v) { 
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + remaining[v]; 
+    } 
+    std::vector<uint32_t> adjacency(indices.size()); 
+    std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1); 
+    for (size_t t = 0; t < triangleCount; ++t) { 
+        for (int c = 0; c < 3; ++c) { 
+            adjacency[fill[indices[t * 3 + c]]++] = static_cast<uint32_t>(t); 
+        } 
+    } 
+
+    std::vector<int> cachePosition(vertexCount, -1); 
+    std::vector<float> vertexScore(vertexCount); 
+    for (size_t v = 0; v < vertexCount; ++v) { 
+        vertexScore[v] = cacheVertexScore(-1, remaining[v]); 
+    } 
+
+    std::vector<bool> emitted(triangleCount, false); 
+    std::vector<float> triangleScore(triangleCount); 
+    for (size_t t = 0; t < triangleCount; ++t) { 
+        triangleScore[t] = vertexScore[indices[t * 3]] 
+                           + vertexScore[indices[t * 3 + 1]] 
+                           + vertexScore[indices[t * 3 + 2]]; 
+    } 
+
+    std::vector<uint32_t> output; 
+    output.reserve(indices.size()); 
+    std::vector<uint32_t> cache; 
+    std::vector<uint32_t> newCache; 
+    cache.reserve(VERTEX_CACHE_SIZE + 3); 
+    newCache.reserve(VERTEX_CACHE_SIZE + 3); 
+
+    size_t scanCursor = 0;   // fallback when nothing in the cache touches a live triangle 
+    int best = 0; 
+    float bestScore = triangleScore[0]; 
+    for (size_t t = 1; t < triangleCount; ++t) { 
+        if (triangleScore[t] > bestScore) { 
+            bestScore = triangleScore[t]; 
+            best = static_cast<int>(t); 
+        } 
+    } 
+
+    while (best >= 0) { 
+        emitted[best] = true; 
+        const uint32_t *tri = &indices[best * 3]; 
+
+        newCache.assign(tri, tri + 3); 
+        for (int c = 0; c < 3; ++c) { 
+            uint32_t v = tri[c]; 
+            output.push_back(v); 
+            --remaining[v]; 
+            // drop the emitted triangle from this vertex's live range 
+            uint32_t *begin = &adjacency[adjacencyOffset[v]]; 
+            uint32_t *end = begin + remaining[v] + 1; 
+            *std::find(begin, end, static_cast<uint32_t>(best)) = *(end - 1); 
+        } 
+        for (uint32_t v : cache) { 
+            if (v != tri[0] && v != tri[1] && v != tri[2]) newCache.push_back(v); 
+        } 
+        for (size_t i = VERTEX_CACHE_SIZE; i < newCache.size(); ++i) { 
+            cachePosition[newCache[i]] = -1;   // evicted 
+            vertexScore[newCache[i]] = cacheVertexScore(-1, remaining[newCache[i]]); 
+        } 
+        if (newCache.size() > VERTEX_CACHE_SIZE) newCache.resize(VERTEX_CACHE_SIZE); 
+        std::swap(cache, newCache); 
+
+        for (size_t i = 0; i < cache.size(); ++i) { 
+            cachePosition[cache[i]] = static_cast<int>(i); 
+            vertexScore[cache[i]] = cacheVertexScore(static_cast<int>(i), remaining[cache[i]]); 
+        } 
+
+        // only triangles touching the cache can have changed score 
+        best = -1; 
+        bestScore = -1.0f; 
+        for (uint32_t v : cache) { 
+            for (uint32_t a = 0; a < remaining[v]; ++a) { 
+                uint32_t t = adjacency[adjacencyOffset[v] + a]; 
+                float score = vertexScore[indices[t * 3]] 
+                              + vertexScore[indices[t * 3 + 1]] 
+                              + vertexScore[indices[t * 3 + 2]]; 
+                triangleScore[t] = score; 
+                if (score > bestScore) { 
+                    bestScore = score; 
+                    best = static_cast<int>(t); 
+                } 
+            } 
+        } 
+
+        if (best < 0) { 
+            while (scanCursor < triangleCount && emitted[scanCursor]) ++scanCursor; 
+            if (scanCursor < triangleCount) best = static_cast<int>(scanCursor); 
+        } 
+    } 
+
+    indices.swap(output); 
+} 
+
 void Tessellator::insertVec3(std::vector<float> &data, const glm::vec3 &v) { 
     data.push_back(v.x); 
     data.push_back(v.y); 
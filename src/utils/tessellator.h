@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint> 
 #include <vector> 
 #include <glm/glm.hpp> 
 
@@ -15,7 +16,19 @@ public:
     static void generateSphere(std::vector<float> &vertices, int param1, int param2); 
     static void generateCylinder(std::vector<float> &vertices, int param1, int param2); 
 
+    /**
+     * Indexed output mode: welds the duplicated vertices of an interleaved
+     * [x, y, z, nx, ny, nz] triangle list into a unique vertex array and
+     * reorders the triangles for the post-transform vertex cache. Vertices are
+     * numbered in first-use order of the final index list. Works on the output
+     * of the generators above and of the shape classes alike.
+     */ 
+    static void buildIndexedMesh(const std::vector<float> &triangleSoup, 
+                                 std::vector<float> &vertices, 
+                                 std::vector<uint32_t> &indices); 
+
 private: 
     static void insertVec3(std::vector<float> &data, const glm::vec3 &v); 
+    static void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount); 
 }; 
 
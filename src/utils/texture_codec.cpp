@@ -0,0 +1,408 @@
+#include "texture_codec.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace {
+struct Rgb {
+    float r, g, b;
+};
+
+size_t blockBytes(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1:
+        case TextureFormat::BC4:
+            return 8;
+        case TextureFormat::BC3:
+        case TextureFormat::BC5:
+            return 16;
+        case TextureFormat::RGBA8:
+            break;
+    }
+    return 0;
+}
+
+GLenum glInternalFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+        case TextureFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+        case TextureFormat::RGBA8: break;
+    }
+    return GL_RGBA8;
+}
+
+// 4x4 texels starting at (bx, by); edge blocks repeat the last row / column
+void fetchBlock(const TextureLevel& rgba, int bx, int by, unsigned char out[16][4]) {
+    for (int y = 0; y < 4; ++y) {
+        int sy = std::min(by + y, rgba.height - 1);
+        for (int x = 0; x < 4; ++x) {
+            int sx = std::min(bx + x, rgba.width - 1);
+            std::memcpy(out[y * 4 + x], rgba.data.data() + (static_cast<size_t>(sy) * rgba.width + sx) * 4, 4);
+        }
+    }
+}
+
+void storeBlock(TextureLevel& rgba, int bx, int by, const unsigned char texels[16][4]) {
+    for (int y = 0; y < 4 && by + y < rgba.height; ++y) {
+        for (int x = 0; x < 4 && bx + x < rgba.width; ++x) {
+            std::memcpy(rgba.data.data() + (static_cast<size_t>(by + y) * rgba.width + bx + x) * 4, texels[y * 4 + x], 4);
+        }
+    }
+}
+
+uint16_t packRgb565(const Rgb& c) {
+    auto q = [](float v, int maxValue) {
+        return static_cast<uint16_t>(std::lround(std::clamp(v, 0.0f, 255.0f) * maxValue / 255.0f));
+    };
+    return static_cast<uint16_t>((q(c.r, 31) << 11) | (q(c.g, 63) << 5) | q(c.b, 31));
+}
+
+Rgb unpackRgb565(uint16_t c) {
+    int r = (c >> 11) & 31;
+    int g = (c >> 5) & 63;
+    int b = c & 31;
+    return {static_cast<float>((r << 3) | (r >> 2)),
+            static_cast<float>((g << 2) | (g >> 4)),
+            static_cast<float>((b << 3) | (b >> 2))};
+}
+
+// BC1 palette; fourColor is forced for the color half of BC3
+std::array<Rgb, 4> bc1Palette(uint16_t c0, uint16_t c1, bool fourColor) {
+    Rgb a = unpackRgb565(c0);
+    Rgb b = unpackRgb565(c1);
+    std::array<Rgb, 4> palette{a, b, Rgb{0, 0, 0}, Rgb{0, 0, 0}};
+    if (fourColor || c0 > c1) {
+        palette[2] = {(2 * a.r + b.r) / 3, (2 * a.g + b.g) / 3, (2 * a.b + b.b) / 3};
+        palette[3] = {(a.r + 2 * b.r) / 3, (a.g + 2 * b.g) / 3, (a.b + 2 * b.b) / 3};
+    } else {
+        palette[2] = {(a.r + b.r) / 2, (a.g + b.g) / 2, (a.b + b.b) / 2};
+    }
+    return palette;
+}
+
+// Range fit along the principal axis of the block's colors
+void encodeBc1Block(const unsigned char texels[16][4], unsigned char* out) {
+    Rgb mean{0, 0, 0};
+    for (int i = 0; i < 16; ++i) {
+        mean.r += texels[i][0];
+        mean.g += texels[i][1];
+        mean.b += texels[i][2];
+    }
+    mean = {mean.r / 16, mean.g / 16, mean.b / 16};
+
+    float cov[6] = {0, 0, 0, 0, 0, 0};   // rr rg rb gg gb bb
+    for (int i = 0; i < 16; ++i) {
+        float r = texels[i][0] - mean.r, g = texels[i][1] - mean.g, b = texels[i][2] - mean.b;
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+    Rgb axis{1, 1, 1};
+    for (int iter = 0; iter < 8; ++iter) {
+        Rgb next{cov[0] * axis.r + cov[1] * axis.g + cov[2] * axis.b,
+                 cov[1] * axis.r + cov[3] * axis.g + cov[4] * axis.b,
+                 cov[2] * axis.r + cov[4] * axis.g + cov[5] * axis.b};
+        float len = std::sqrt(next.r * next.r + next.g * next.g + next.b * next.b);
+        if (len < 1e-6f) break;   // flat block: any axis works
+        axis = {next.r / len, next.g / len, next.b / len};
+    }
+
+    float lo = 0, hi = 0;
+    for (int i = 0; i < 16; ++i) {
+        float t = (texels[i][0] - mean.r) * axis.r + (texels[i][1] - mean.g) * axis.g + (texels[i][2] - mean.b) * axis.b;
+        lo = std::min(lo, t);
+        hi = std::max(hi, t);
+    }
+    uint16_t c0 = packRgb565({mean.r + axis.r * hi, mean.g + axis.g * hi, mean.b + axis.b * hi});
+    uint16_t c1 = packRgb565({mean.r + axis.r * lo, mean.g + axis.g * lo, mean.b + axis.b * lo});
+    if (c0 < c1) std::swap(c0, c1);   // c0 > c1 selects the 4-color mode
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        std::array<Rgb, 4> palette = bc1Palette(c0, c1, true);
+        for (int i = 0; i < 16; ++i) {
+            int best = 0;
+            float bestDist = 1e30f;
+            for (int p = 0; p < 4; ++p) {
+                float dr = texels[i][0] - palette[p].r, dg = texels[i][1] - palette[p].g, db = texels[i][2] - palette[p].b;
+                float dist = dr * dr + dg * dg + db * db;
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+        }
+    }
+    std::memcpy(out, &c0, 2);
+    std::memcpy(out + 2, &c1, 2);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+void decodeBc1Block(const unsigned char* in, bool fourColor, unsigned char texels[16][4]) {
+    uint16_t c0, c1;
+    uint32_t indices;
+    std::memcpy(&c0, in, 2);
+    std::memcpy(&c1, in + 2, 2);
+    std::memcpy(&indices, in + 4, 4);
+    std::array<Rgb, 4> palette = bc1Palette(c0, c1, fourColor);
+    for (int i = 0; i < 16; ++i) {
+        const Rgb& c = palette[(indices >> (2 * i)) & 3];
+        texels[i][0] = static_cast<unsigned char>(std::lround(c.r));
+        texels[i][1] = static_cast<unsigned char>(std::lround(c.g));
+        texels[i][2] = static_cast<unsigned char>(std::lround(c.b));
+    }
+}
+
+// Eight-value mode (r0 > r1) between the block's min and max
+void encodeBc4Block(const unsigned char texels[16][4], int channel, unsigned char* out) {
+    unsigned char lo = 255, hi = 0;
+    for (int i = 0; i < 16; ++i) {
+        lo = std::min(lo, texels[i][channel]);
+        hi = std::max(hi, texels[i][channel]);
+    }
+    out[0] = hi;
+    out[1] = lo;
+
+    uint64_t indices = 0;
+    if (hi > lo) {
+        // Palette order: 0 = hi, 1 = lo, 2..7 = hi -> lo in sevenths
+        for (int i = 0; i < 16; ++i) {
+            float t = static_cast<float>(hi - texels[i][channel]) / (hi - lo);   // 0 at hi, 1 at lo
+            int step = static_cast<int>(std::lround(t * 7));
+            int index = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+            indices |= static_cast<uint64_t>(index) << (3 * i);
+        }
+    }
+    for (int b = 0; b < 6; ++b) {
+        out[2 + b] = static_cast<unsigned char>(indices >> (8 * b));
+    }
+}
+
+void decodeBc4Block(const unsigned char* in, int channel, unsigned char texels[16][4]) {
+    int r0 = in[0], r1 = in[1];
+    int palette[8] = {r0, r1, 0, 0, 0, 0, 0, 255};
+    if (r0 > r1) {
+        for (int i = 1; i <= 6; ++i) palette[i + 1] = ((7 - i) * r0 + i * r1 + 3) / 7;
+    } else {
+        for (int i = 1; i <= 4; ++i) palette[i + 1] = ((5 - i) * r0 + i * r1 + 2) / 5;
+    }
+    uint64_t indices = 0;
+    for (int b = 0; b < 6; ++b) {
+        indices |= static_cast<uint64_t>(in[2 + b]) << (8 * b);
+    }
+    for (int i = 0; i < 16; ++i) {
+        texels[i][channel] = static_cast<unsigned char>(palette[(indices >> (3 * i)) & 7]);
+    }
+}
+}
+
+std::vector<TextureLevel> TextureCodec::buildMipChain(const unsigned char* pixels, int width, int height, int channels) {
+    std::vector<TextureLevel> levels;
+    if (!pixels || width <= 0 || height <= 0 || channels < 1 || channels > 4) return levels;
+
+    // Level 0: expand to RGBA (grey and grey+alpha images keep their grey in RGB)
+    TextureLevel base;
+    base.width = width;
+    base.height = height;
+    base.data.resize(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0, n = static_cast<size_t>(width) * height; i < n; ++i) {
+        const unsigned char* src = pixels + i * channels;
+        unsigned char* dst = base.data.data() + i * 4;
+        if (channels <= 2) {
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = channels == 2 ? src[1] : 255;
+        } else {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = channels == 4 ? src[3] : 255;
+        }
+    }
+    levels.push_back(std::move(base));
+
+    // 2x2 box filter per level; odd edges reuse the last row / column
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        const TextureLevel& src = levels.back();
+        TextureLevel next;
+        next.width = std::max(1, src.width / 2);
+        next.height = std::max(1, src.height / 2);
+        next.data.resize(static_cast<size_t>(next.width) * next.height * 4);
+        for (int y = 0; y < next.height; ++y) {
+            int y0 = std::min(2 * y, src.height - 1), y1 = std::min(2 * y + 1, src.height - 1);
+            for (int x = 0; x < next.width; ++x) {
+                int x0 = std::min(2 * x, src.width - 1), x1 = std::min(2 * x + 1, src.width - 1);
+                for (int c = 0; c < 4; ++c) {
+                    auto at = [&](int sx, int sy) { return src.data[(static_cast<size_t>(sy) * src.width + sx) * 4 + c]; };
+                    int sum = at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1);
+                    next.data[(static_cast<size_t>(y) * next.width + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+        levels.push_back(std::move(next));
+    }
+    return levels;
+}
+
+size_t TextureCodec::levelBytes(TextureFormat format, int width, int height) {
+    if (format == TextureFormat::RGBA8) return static_cast<size_t>(width) * height * 4;
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+}
+
+TextureLevel TextureCodec::encode(TextureFormat format, const TextureLevel& rgba) {
+    TextureLevel out;
+    out.width = rgba.width;
+    out.height = rgba.height;
+    out.data.resize(levelBytes(format, rgba.width, rgba.height));
+
+    unsigned char texels[16][4];
+    unsigned char* dst = out.data.data();
+    const size_t stride = blockBytes(format);
+    for (int by = 0; by < rgba.height; by += 4) {
+        for (int bx = 0; bx < rgba.width; bx += 4, dst += stride) {
+            fetchBlock(rgba, bx, by, texels);
+            switch (format) {
+                case TextureFormat::BC1:
+                    encodeBc1Block(texels, dst);
+                    break;
+                case TextureFormat::BC3:
+                    encodeBc4Block(texels, 3, dst);
+                    encodeBc1Block(texels, dst + 8);
+                    break;
+                case TextureFormat::BC4:
+                    encodeBc4Block(texels, 0, dst);
+                    break;
+                case TextureFormat::BC5:
+                    encodeBc4Block(texels, 0, dst);
+                    encodeBc4Block(texels, 1, dst + 8);
+                    break;
+                case TextureFormat::RGBA8:
+                    break;
+            }
+        }
+    }
+    return out;
+}
+
+TextureLevel TextureCodec::decode(TextureFormat format, const TextureLevel& blocks) {
+    TextureLevel out;
+    out.width = blocks.width;
+    out.height = blocks.height;
+    out.data.resize(static_cast<size_t>(blocks.width) * blocks.height * 4);
+
+    unsigned char texels[16][4];
+    const unsigned char* src = blocks.data.data();
+    const size_t stride = blockBytes(format);
+    for (int by = 0; by < blocks.height; by += 4) {
+        for (int bx = 0; bx < blocks.width; bx += 4, src += stride) {
+            for (auto& texel : texels) texel[3] = 255;
+            switch (format) {
+                case TextureFormat::BC1:
+                    decodeBc1Block(src, false, texels);
+                    break;
+                case TextureFormat::BC3:
+                    decodeBc4Block(src, 3, texels);
+                    decodeBc1Block(src + 8, true, texels);
+                    break;
+                case TextureFormat::BC4:
+                    decodeBc4Block(src, 0, texels);
+                    for (auto& texel : texels) texel[1] = texel[2] = texel[0];
+                    break;
+                case TextureFormat::BC5:
+                    decodeBc4Block(src, 0, texels);
+                    decodeBc4Block(src + 8, 1, texels);
+                    for (auto& texel : texels) {
+                        // Same reconstruction as default.frag
+                        float x = texel[0] / 255.0f * 2.0f - 1.0f;
+                        float y = texel[1] / 255.0f * 2.0f - 1.0f;
+                        float z = std::sqrt(std::max(0.0f, 1.0f - x * x - y * y));
+                        texel[2] = static_cast<unsigned char>(std::lround((z * 0.5f + 0.5f) * 255.0f));
+                    }
+                    break;
+                case TextureFormat::RGBA8:
+                    break;
+            }
+            storeBlock(out, bx, by, texels);
+        }
+    }
+    return out;
+}
+
+float TextureCodec::rmse(TextureFormat format, const TextureLevel& a, const TextureLevel& b) {
+    int firstChannel = 0, channelCount = 3;
+    if (format == TextureFormat::BC3 || format == TextureFormat::RGBA8) channelCount = 4;
+    if (format == TextureFormat::BC4) channelCount = 1;
+    if (format == TextureFormat::BC5) channelCount = 2;
+
+    const size_t texels = std::min(a.data.size(), b.data.size()) / 4;
+    if (texels == 0) return 0.0f;
+    double sum = 0.0;
+    for (size_t i = 0; i < texels; ++i) {
+        for (int c = firstChannel; c < firstChannel + channelCount; ++c) {
+            double d = static_cast<double>(a.data[i * 4 + c]) - b.data[i * 4 + c];
+            sum += d * d;
+        }
+    }
+    return static_cast<float>(std::sqrt(sum / (texels * channelCount)));
+}
+
+bool TextureCodec::formatSupported(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1:
+        case TextureFormat::BC3:
+            return GLEW_EXT_texture_compression_s3tc;   // everywhere on desktop, but still an extension
+        case TextureFormat::BC4:
+        case TextureFormat::BC5:
+        case TextureFormat::RGBA8:
+            return true;                                // RGTC is core since GL 3.0
+    }
+    return false;
+}
+
+void TextureCodec::upload(TextureFormat format, const std::vector<TextureLevel>& levels) {
+    const bool direct = formatSupported(format);
+
+    GLint prevUnpackAlignment = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevUnpackAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const TextureLevel& level = levels[i];
+        const GLint mip = static_cast<GLint>(i);
+        if (format == TextureFormat::RGBA8) {
+            glTexImage2D(GL_TEXTURE_2D, mip, GL_RGBA8, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                         level.data.data());
+        } else if (direct) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, mip, glInternalFormat(format), level.width, level.height, 0,
+                                   static_cast<GLsizei>(level.data.size()), level.data.data());
+        } else {
+            TextureLevel rgba = decode(format, level);
+            glTexImage2D(GL_TEXTURE_2D, mip, GL_RGBA8, rgba.width, rgba.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                         rgba.data.data());
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, std::max<GLint>(0, static_cast<GLint>(levels.size()) - 1));
+
+    // BC4 keeps one channel; show it as grey like the RGBA fallback does
+    if (format == TextureFormat::BC4 && direct) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_ONE);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prevUnpackAlignment);
+}
+
+void TextureCodec::applyFiltering() {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (GLEW_EXT_texture_filter_anisotropic) {
+        GLfloat maxAnisotropy = 1.0f;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(maxAnisotropy, 8.0f));
+    }
+}
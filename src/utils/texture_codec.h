@@ -0,0 +1,57 @@
+#pragma once
+
+// Defined before including GLEW to suppress deprecation messages on macOS
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <vector>
+
+// Storage format of a texture's mip chain
+enum class TextureFormat : uint8_t {
+    RGBA8,      // uncompressed, 4 bytes per texel
+    BC1,        // RGB, 8 bytes per 4x4 block (S3TC DXT1)
+    BC3,        // RGBA, 16 bytes per block (S3TC DXT5: BC4-style alpha + BC1 color)
+    BC4,        // one channel, 8 bytes per block (RGTC1); sampled as grey through a swizzle
+    BC5         // two channels, 16 bytes per block (RGTC2); normal maps, z rebuilt in the shader
+};
+
+struct TextureLevel {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> data;   // RGBA8 texels or compressed blocks, rows in upload order
+};
+
+/**
+ * CPU side of the texture pipeline: box-filtered mip chains, BC1/BC3/BC4/BC5 block encoding and a
+ * matching decoder. The decoder lets encoded blocks be checked on the CPU (encode() output is
+ * compared against its source before it is kept) and backs the RGBA8 fallback on GL drivers
+ * without S3TC. BC7 / ETC2 are not offered: neither is core in the GL 4.1 profile we target.
+ *
+ * upload() and applyFiltering() are the GL side and need a current context; everything else is
+ * pure CPU and safe on the GLB worker threads.
+ */
+class TextureCodec {
+public:
+    // RGBA8 mip chain from 1-4 channel 8-bit pixels, down to 1x1
+    static std::vector<TextureLevel> buildMipChain(const unsigned char* pixels, int width, int height, int channels);
+
+    // Compress one RGBA8 level (format must not be RGBA8)
+    static TextureLevel encode(TextureFormat format, const TextureLevel& rgba);
+    // Expand compressed blocks back to RGBA8 (BC4 -> grey, BC5 -> RG with z rebuilt into B)
+    static TextureLevel decode(TextureFormat format, const TextureLevel& blocks);
+
+    // Root-mean-square error over the channels a format stores, in 8-bit units
+    static float rmse(TextureFormat format, const TextureLevel& a, const TextureLevel& b);
+
+    static size_t levelBytes(TextureFormat format, int width, int height);
+
+    // Whether the current context can sample the format directly
+    static bool formatSupported(TextureFormat format);
+    // Upload a mip chain into the texture bound to GL_TEXTURE_2D (decoding if unsupported)
+    static void upload(TextureFormat format, const std::vector<TextureLevel>& levels);
+    // Trilinear filtering plus the highest anisotropy the driver offers
+    static void applyFiltering();
+};
@@ -0,0 +1,88 @@
+#include "texture_registry.h"
+
+#include <filesystem>
+#include <iostream>
+
+TextureRegistry& TextureRegistry::instance() {
+    static TextureRegistry registry;
+    return registry;
+}
+
+GLuint TextureRegistry::acquire(uint64_t contentHash) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_byHash.find(contentHash);
+    if (it == m_byHash.end()) return 0;
+    ++it->second.refs;
+    return it->second.textureId;
+}
+
+void TextureRegistry::insert(GLuint textureId, const std::string& sourceKey, const Info& info) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_byHash[info.contentHash];
+    if (entry.textureId != 0) {
+        // Callers acquire() first, so this only happens on a hash collision; keep the resident one
+        std::cerr << "[TextureRegistry] Content hash already registered, texture " << textureId
+                  << " is not shared" << std::endl;
+        return;
+    }
+    entry.textureId = textureId;
+    entry.refs = 1;
+    entry.sourceKey = sourceKey;
+    entry.info = info;
+    m_hashById[textureId] = info.contentHash;
+    if (!sourceKey.empty()) m_hashBySource[sourceKey] = info.contentHash;
+}
+
+void TextureRegistry::release(GLuint textureId) {
+    if (textureId == 0) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto idIt = m_hashById.find(textureId);
+    if (idIt == m_hashById.end()) {
+        // Not shared (see insert); owned by its model alone
+        glDeleteTextures(1, &textureId);
+        return;
+    }
+    auto it = m_byHash.find(idIt->second);
+    if (--it->second.refs > 0) return;
+
+    glDeleteTextures(1, &textureId);
+    if (!it->second.sourceKey.empty()) m_hashBySource.erase(it->second.sourceKey);
+    m_byHash.erase(it);
+    m_hashById.erase(idIt);
+}
+
+bool TextureRegistry::findSource(const std::string& sourceKey, Info& out) const {
+    if (sourceKey.empty()) return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_hashBySource.find(sourceKey);
+    if (it == m_hashBySource.end()) return false;
+    out = m_byHash.at(it->second).info;
+    return true;
+}
+
+std::string TextureRegistry::sourceKey(const std::string& path, bool normalMap) {
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+    if (ec) return {};
+    uintmax_t size = std::filesystem::file_size(canonical, ec);
+    if (ec) return {};
+    auto mtime = std::filesystem::last_write_time(canonical, ec);
+    if (ec) return {};
+    return canonical.string() + "|" + std::to_string(size) + "|" +
+           std::to_string(mtime.time_since_epoch().count()) + (normalMap ? "|normal" : "|color");
+}
+
+uint64_t TextureRegistry::contentHash(const TextureLevel& rgba, TextureFormat format) {
+    // FNV-1a over format, size and texels
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const unsigned char* bytes, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    const int header[3] = {static_cast<int>(format), rgba.width, rgba.height};
+    mix(reinterpret_cast<const unsigned char*>(header), sizeof(header));
+    mix(rgba.data.data(), rgba.data.size());
+    return hash;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+// Defined before including GLEW to suppress deprecation messages on macOS
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#endif
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "texture_codec.h"
+
+/**
+ * Process-wide, reference-counted set of GL textures shared by every GLB model.
+ *
+ * Textures are keyed by a content hash (source pixels + storage format), so identical images in
+ * different materials or models are uploaded once. Textures loaded from files additionally carry a
+ * source key (resolved path, size, mtime and role); while such a texture is resident, parsing a
+ * model that names the same file skips decoding and encoding it altogether.
+ *
+ * acquire / insert / release create or delete GL objects and belong to the GL thread. findSource
+ * only reads the bookkeeping and may be called from the GLB worker threads.
+ */
+class TextureRegistry {
+public:
+    // What a parse needs to stand in for a texture it did not decode
+    struct Info {
+        uint64_t contentHash = 0;
+        TextureFormat format = TextureFormat::RGBA8;
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+    };
+
+    static TextureRegistry& instance();
+
+    // Texture for contentHash with one more reference, or 0 if none is resident
+    GLuint acquire(uint64_t contentHash);
+    // Register a freshly uploaded texture with one reference (sourceKey may be empty)
+    void insert(GLuint textureId, const std::string& sourceKey, const Info& info);
+    // Drop one reference; the GL texture is deleted with the last one
+    void release(GLuint textureId);
+
+    // Info of the resident texture decoded from sourceKey
+    bool findSource(const std::string& sourceKey, Info& out) const;
+
+    // Source key of an image file, empty if the file cannot be stat'ed
+    static std::string sourceKey(const std::string& path, bool normalMap);
+    // Content hash of an RGBA8 level as it will be stored in format
+    static uint64_t contentHash(const TextureLevel& rgba, TextureFormat format);
+
+private:
+    TextureRegistry() = default;
+
+    struct Entry {
+        GLuint textureId = 0;
+        int refs = 0;
+        std::string sourceKey;
+        Info info;
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, Entry> m_byHash;
+    std::unordered_map<GLuint, uint64_t> m_hashById;
+    std::unordered_map<std::string, uint64_t> m_hashBySource;
+};
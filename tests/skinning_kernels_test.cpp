@@ -0,0 +1,93 @@
+// Checks the batch skinning kernels against their *Scalar twins on random skeletons.
+// Built once per backend (see CMakeLists.txt); exits non-zero on any mismatch.
+
+#include "utils/skinning_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+// Relative to the magnitude of the reference value, a few ulps of float rounding
+constexpr float kTolerance = 1e-5f;
+
+int g_failures = 0;
+
+float relativeError(float value, float reference) {
+    return std::fabs(value - reference) / std::max(1.0f, std::fabs(reference));
+}
+
+void expectClose(const char* kernel, size_t joints, const float* values, const float* reference, size_t count) {
+    float worst = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        worst = std::max(worst, relativeError(values[i], reference[i]));
+    }
+    if (worst > kTolerance) {
+        std::cerr << "FAIL " << kernel << " (" << joints << " joints): error " << worst << std::endl;
+        ++g_failures;
+    }
+}
+
+glm::quat randomRotation(std::mt19937& rng) {
+    std::normal_distribution<float> n(0.0f, 1.0f);
+    return glm::normalize(glm::quat(n(rng), n(rng), n(rng), n(rng)));
+}
+
+glm::mat4 randomAffine(std::mt19937& rng) {
+    std::uniform_real_distribution<float> t(-2.0f, 2.0f), s(0.5f, 1.5f);
+    glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(t(rng), t(rng), t(rng)));
+    m = m * glm::mat4_cast(randomRotation(rng));
+    return glm::scale(m, glm::vec3(s(rng), s(rng), s(rng)));
+}
+
+void checkSkeleton(std::mt19937& rng, size_t joints) {
+    std::uniform_real_distribution<float> t(-2.0f, 2.0f), s(0.5f, 1.5f);
+
+    // Random poses; each joint's parent comes earlier, so index order is a valid jointOrder
+    JointPoseSoA poses;
+    poses.resize(joints);
+    std::vector<int> parents(joints), order(joints);
+    std::vector<glm::mat4> inverseBinds(joints);
+    for (size_t j = 0; j < joints; ++j) {
+        poses.set(j, glm::vec3(t(rng), t(rng), t(rng)), randomRotation(rng), glm::vec3(s(rng), s(rng), s(rng)));
+        parents[j] = j == 0 ? -1 : std::uniform_int_distribution<int>(-1, static_cast<int>(j) - 1)(rng);
+        order[j] = static_cast<int>(j);
+        inverseBinds[j] = glm::inverse(randomAffine(rng));
+    }
+    const glm::mat4 root = randomAffine(rng);
+
+    std::vector<glm::mat4> locals(joints), localsRef(joints);
+    SkinningKernels::composeLocals(poses, locals.data());
+    SkinningKernels::composeLocalsScalar(poses, localsRef.data());
+    expectClose("composeLocals", joints, &locals[0][0][0], &localsRef[0][0][0], joints * 16);
+
+    // Chain the remaining kernels on the reference input so each is checked on its own
+    std::vector<glm::mat4> globals(joints), globalsRef(joints);
+    SkinningKernels::composeGlobals(localsRef.data(), parents.data(), order.data(), joints, root, globals.data());
+    SkinningKernels::composeGlobalsScalar(localsRef.data(), parents.data(), order.data(), joints, root,
+                                          globalsRef.data());
+    expectClose("composeGlobals", joints, &globals[0][0][0], &globalsRef[0][0][0], joints * 16);
+
+    std::vector<glm::vec4> palette(joints * 3), paletteRef(joints * 3);
+    SkinningKernels::composePalette(globalsRef.data(), inverseBinds.data(), joints, palette.data());
+    SkinningKernels::composePaletteScalar(globalsRef.data(), inverseBinds.data(), joints, paletteRef.data());
+    expectClose("composePalette", joints, &palette[0][0], &paletteRef[0][0], joints * 12);
+}
+}
+
+int main() {
+    std::mt19937 rng(1234);
+    // Odd sizes exercise the padding past the last group of four
+    for (size_t joints : {1, 3, 4, 7, 64, 100, 255}) {
+        for (int round = 0; round < 20; ++round) {
+            checkSkeleton(rng, joints);
+        }
+    }
+
+    std::cout << "skinning kernels (" << SkinningKernels::backend() << "): "
+              << (g_failures == 0 ? "OK" : "FAILED") << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
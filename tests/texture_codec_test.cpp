@@ -0,0 +1,145 @@
+// Checks the BC1/BC3/BC4/BC5 encoders against their decoders on the CPU: round trips of typical
+// blocks stay within an error bound, edge blocks of odd-sized levels come back at the right size,
+// and levelBytes() matches what encode() produces. Exits non-zero on any failure.
+
+#include "utils/texture_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+void expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAIL " << what << std::endl;
+        ++g_failures;
+    }
+}
+
+const char* formatName(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1: return "BC1";
+        case TextureFormat::BC3: return "BC3";
+        case TextureFormat::BC4: return "BC4";
+        case TextureFormat::BC5: return "BC5";
+        case TextureFormat::RGBA8: return "RGBA8";
+    }
+    return "?";
+}
+
+constexpr TextureFormat kFormats[] = {TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC4, TextureFormat::BC5};
+
+// RGBA8 level whose texel (x, y) is texel(x, y)
+TextureLevel makeLevel(int width, int height, const std::function<void(int, int, unsigned char*)>& texel) {
+    TextureLevel level;
+    level.width = width;
+    level.height = height;
+    level.data.resize(static_cast<size_t>(width) * height * 4);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            texel(x, y, level.data.data() + (static_cast<size_t>(y) * width + x) * 4);
+        }
+    }
+    return level;
+}
+
+// Encode, check the size against levelBytes, decode, and return the error over the stored channels
+float roundTrip(TextureFormat format, const TextureLevel& rgba, const std::string& name) {
+    TextureLevel blocks = TextureCodec::encode(format, rgba);
+    const std::string label = std::string(formatName(format)) + " " + name + " " + std::to_string(rgba.width) + "x" +
+                              std::to_string(rgba.height);
+    expect(blocks.data.size() == TextureCodec::levelBytes(format, rgba.width, rgba.height), label + ": levelBytes");
+
+    TextureLevel decoded = TextureCodec::decode(format, blocks);
+    expect(decoded.width == rgba.width && decoded.height == rgba.height, label + ": decoded size");
+    expect(decoded.data.size() == rgba.data.size(), label + ": decoded bytes");
+    return TextureCodec::rmse(format, rgba, decoded);
+}
+
+void expectRoundTrip(const TextureLevel& rgba, const std::string& name, float bound) {
+    for (TextureFormat format : kFormats) {
+        float error = roundTrip(format, rgba, name);
+        if (error > bound) {
+            std::cerr << "FAIL " << formatName(format) << " " << name << " " << rgba.width << "x" << rgba.height
+                      << ": rmse " << error << " > " << bound << std::endl;
+            ++g_failures;
+        }
+    }
+}
+
+void checkBlocks() {
+    // 5:6:5 endpoints are off by at most 4 from an 8-bit colour
+    expectRoundTrip(makeLevel(4, 4, [](int, int, unsigned char* t) {
+        t[0] = 200; t[1] = 90; t[2] = 30; t[3] = 255;
+    }), "flat", 4.0f);
+
+    // A smooth ramp along a line in colour space, which a block's four-colour palette can follow
+    expectRoundTrip(makeLevel(4, 4, [](int x, int y, unsigned char* t) {
+        int i = y * 4 + x;
+        t[0] = static_cast<unsigned char>(60 + i * 4);
+        t[1] = static_cast<unsigned char>(180 - i * 3);
+        t[2] = static_cast<unsigned char>(90 + i * 2);
+        t[3] = 255;
+    }), "gradient", 8.0f);
+
+    expectRoundTrip(makeLevel(4, 4, [](int x, int y, unsigned char* t) {
+        bool a = (x + y) % 2 == 0;
+        t[0] = a ? 255 : 16;
+        t[1] = a ? 255 : 64;
+        t[2] = a ? 255 : 128;
+        t[3] = 255;
+    }), "two-colour", 4.0f);
+
+    // Alpha lives only in BC3; its BC4-style channel has eight levels between its endpoints
+    TextureLevel alpha = makeLevel(4, 4, [](int x, int y, unsigned char* t) {
+        t[0] = 120; t[1] = 180; t[2] = 240;
+        t[3] = static_cast<unsigned char>((y * 4 + x) * 17);
+    });
+    expectRoundTrip(alpha, "alpha", 12.0f);
+    TextureLevel decoded = TextureCodec::decode(TextureFormat::BC3, TextureCodec::encode(TextureFormat::BC3, alpha));
+    float alphaError = 0.0f;
+    for (size_t i = 3; i < alpha.data.size(); i += 4) {
+        alphaError = std::max(alphaError, std::fabs(float(alpha.data[i]) - float(decoded.data[i])));
+    }
+    // Half the spacing of eight levels over 0-255, plus rounding
+    expect(alphaError <= 19.0f, "BC3 alpha: per-texel alpha error " + std::to_string(alphaError));
+}
+
+void checkEdgeLevels() {
+    // Sizes below and between block multiples go through the edge repeat of fetchBlock / storeBlock
+    const int sizes[][2] = {{1, 1}, {2, 2}, {1, 4}, {3, 5}, {6, 2}, {7, 9}, {13, 6}};
+    for (const auto& size : sizes) {
+        expectRoundTrip(makeLevel(size[0], size[1], [](int, int, unsigned char* t) {
+            t[0] = 40; t[1] = 160; t[2] = 220; t[3] = 255;
+        }), "flat edge", 4.0f);
+    }
+
+    // A whole mip chain of an odd-sized image, down to 1x1
+    TextureLevel base = makeLevel(13, 6, [](int x, int y, unsigned char* t) {
+        t[0] = static_cast<unsigned char>(x * 19);
+        t[1] = static_cast<unsigned char>(y * 40);
+        t[2] = 128;
+        t[3] = 255;
+    });
+    std::vector<TextureLevel> chain = TextureCodec::buildMipChain(base.data.data(), base.width, base.height, 4);
+    expect(!chain.empty() && chain.back().width == 1 && chain.back().height == 1, "mip chain ends at 1x1");
+    for (const TextureLevel& level : chain) {
+        for (TextureFormat format : kFormats) {
+            roundTrip(format, level, "mip");
+        }
+    }
+}
+}
+
+int main() {
+    checkBlocks();
+    checkEdgeLevels();
+
+    std::cout << "texture codec: " << (g_failures == 0 ? "OK" : "FAILED") << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}